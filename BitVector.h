@@ -0,0 +1,257 @@
+/*
+ * BitVector.h
+ *
+ *      Purpose: A vector of bools packed eight to a byte, with operations that work on a whole word of them at a time.
+ */
+
+#ifndef BIT_VECTOR_H
+#define BIT_VECTOR_H
+
+#include "Vector.h"
+
+// The bits are stored a word at a time in the natural word of the processor - a byte on AVR, where anything wider takes several
+// instructions to do anything with, and 32 bits everywhere else
+#if defined(__AVR__)
+typedef uint8_t BitVectorWord;
+#else
+typedef uint32_t BitVectorWord;
+#endif
+
+// Bit n of the vector is bit n % BitsPerWord of word n / BitsPerWord. Any bits in the last word past the end of the vector are kept
+// clear, which is what lets Count and the rest work on whole words without masking off the end. The words themselves are kept in a
+// Vector, so they come from Allocator and grow by Growth like any other.
+//
+// This is a class of its own rather than a specialisation of Vector<bool> since a bit can't be returned by reference, so operator[]
+// returns a small proxy that reads or writes the bit it refers to instead. Declare one with empty brackets to use the defaults:
+//
+//   BitVector<> faults(16);
+//   faults[3] = true;
+template <class Allocator = VectorHeapAllocator, class Growth = VectorGrowDouble> class BitVector
+{
+    static const int BitsPerWord = sizeof(BitVectorWord) * 8;
+    static const BitVectorWord AllSet = (BitVectorWord)~(BitVectorWord)0;
+
+    Vector<BitVectorWord, Allocator, Growth> words;
+    // The number of bits in the vector
+    int bits;
+    // Where the proxies returned for bits that are out of bounds point, so that writing to them does no harm
+    BitVectorWord ob;
+
+public:
+    // Stands in for a reference to a single bit
+    class Reference
+    {
+        BitVectorWord *word;
+        BitVectorWord mask;
+
+    public:
+        Reference(BitVectorWord *word, BitVectorWord mask) : word(word), mask(mask) { }
+
+        operator bool() const { return (*word & mask) != 0; }
+
+        Reference &operator=(bool value)
+        {
+            if(value)
+                *word |= mask;
+            else
+                *word &= ~mask;
+
+            return *this;
+        }
+
+        Reference &operator=(const Reference &other) { return *this = (bool)other; }
+    };
+
+    BitVector(int initialSize = 0, bool value = false, const Allocator &allocator = Allocator()) : words(allocator), bits(0), ob(0)
+    {
+        Resize(initialSize, value);
+    }
+
+    // Adds a bit to the back of the vector. Returns false if there wasn't enough memory for it.
+    bool PushBack(bool value)
+    {
+        if(bits == words.Size() * BitsPerWord && !words.PushBack(0))
+            return false;
+
+        Set(bits++, value);
+
+        return true;
+    }
+
+    // Removes the last bit
+    void PopBack()
+    {
+        if(bits > 0)
+        {
+            Set(--bits, false);
+
+            if(bits % BitsPerWord == 0)
+                words.PopBack();
+        }
+    }
+
+    void Clear()
+    {
+        words.Clear();
+        bits = 0;
+    }
+
+    bool Empty() const { return bits == 0; }
+
+    // Returns the nth bit of the vector, which can be assigned to
+    Reference operator[](int n)
+    {
+        if(n >= 0 && n < bits)
+            return Reference(words.Data() + n / BitsPerWord, Mask(n));
+
+        // Anything written to this is forgotten by the next time round, so it always reads as false
+        ob = 0;
+        return Reference(&ob, 1);
+    }
+
+    // Returns the nth bit, or false if it's out of bounds
+    bool operator[](int n) const { return n >= 0 && n < bits && Get(n); }
+
+    // These read and write the nth bit without checking that there is one, so it's up to the caller to be sure n is less than Size()
+    bool Get(int n) const { return (words.At(n / BitsPerWord) & Mask(n)) != 0; }
+
+    void Set(int n, bool value = true)
+    {
+        if(value)
+            words.At(n / BitsPerWord) |= Mask(n);
+        else
+            words.At(n / BitsPerWord) &= ~Mask(n);
+    }
+
+    void Reset(int n) { Set(n, false); }
+
+    void Flip(int n) { words.At(n / BitsPerWord) ^= Mask(n); }
+
+    // Returns the number of bits that are set
+    int Count() const
+    {
+        int count = 0;
+
+        for(const BitVectorWord *word = words.begin(); word != words.end(); ++word)
+            count += __builtin_popcountl(*word);
+
+        return count;
+    }
+
+    // Returns the index of the first set bit from first on, or -1 if there isn't one. Words with nothing set are skipped whole.
+    int FindFirstSet(int first = 0) const
+    {
+        if(first < 0)
+            first = 0;
+
+        if(first >= bits)
+            return -1;
+
+        int word = first / BitsPerWord;
+
+        // Ignore the bits in the first word that come before first
+        BitVectorWord remaining = words.At(word) & (BitVectorWord)(AllSet << (first % BitsPerWord));
+
+        while(!remaining)
+        {
+            if(++word == words.Size())
+                return -1;
+
+            remaining = words.At(word);
+        }
+
+        return word * BitsPerWord + __builtin_ctzl(remaining);
+    }
+
+    // Clears every bit that isn't also set in other, a word at a time. Bits past the end of other count as clear.
+    void And(const BitVector &other)
+    {
+        int common = MIN(words.Size(), other.words.Size());
+
+        for(int i = 0; i < common; i++)
+            words.At(i) &= other.words.At(i);
+
+        for(int i = common; i < words.Size(); i++)
+            words.At(i) = 0;
+    }
+
+    // Sets every bit that's set in other, a word at a time. Bits past the end of this vector are left out.
+    void Or(const BitVector &other)
+    {
+        int common = MIN(words.Size(), other.words.Size());
+
+        for(int i = 0; i < common; i++)
+            words.At(i) |= other.words.At(i);
+
+        ClearPastEnd();
+    }
+
+    // Sets (or clears) every bit in the vector
+    void Fill(bool value)
+    {
+        for(BitVectorWord *word = words.begin(); word != words.end(); ++word)
+            *word = value ? AllSet : 0;
+
+        ClearPastEnd();
+    }
+
+    // Resizes the vector to size bits, any new ones being set to value. Returns false, leaving the size as it was, if the memory
+    // couldn't be found.
+    bool Resize(int size, bool value = false)
+    {
+        int needed = (size + BitsPerWord - 1) / BitsPerWord;
+
+        if(!words.Reserve(needed))
+            return false;
+
+        if(size > bits)
+        {
+            // Fill out the last of the existing words a bit at a time then add whole words for the rest
+            for(; bits < size && bits % BitsPerWord; bits++)
+                Set(bits, value);
+
+            while(words.Size() < needed)
+                words.PushBack(value ? AllSet : 0);
+        }
+        else
+            words.Resize(needed);
+
+        bits = size;
+        ClearPastEnd();
+
+        return true;
+    }
+
+    // Makes sure there's room for size bits. Returns false if the memory couldn't be found.
+    bool Reserve(int size) { return words.Reserve((size + BitsPerWord - 1) / BitsPerWord); }
+
+    // Hands back any words beyond what the bits need
+    bool ShrinkToFit() { return words.ShrinkToFit(); }
+
+    // Returns the number of bits the vector will hold before it needs resizing
+    int Capacity() const { return words.Capacity() * BitsPerWord; }
+
+    // Returns the number of bits in the vector
+    int Size() const { return bits; }
+
+    // Returns the words that the bits are packed into, for working on them directly. Any bits past Size() in the last one should
+    // be left clear.
+    BitVectorWord *Data() { return words.Data(); }
+    const BitVectorWord *Data() const { return words.Data(); }
+
+    // Returns the number of words that the bits are packed into
+    int Words() const { return words.Size(); }
+
+private:
+
+    static BitVectorWord Mask(int n) { return (BitVectorWord)1 << (n % BitsPerWord); }
+
+    // Clears any bits in the last word past the end of the vector
+    void ClearPastEnd()
+    {
+        if(bits % BitsPerWord)
+            words.At(words.Size() - 1) &= (BitVectorWord)(((BitVectorWord)1 << (bits % BitsPerWord)) - 1);
+    }
+};
+
+#endif // BIT_VECTOR_H
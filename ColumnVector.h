@@ -0,0 +1,231 @@
+/*
+ * ColumnVector.h
+ *
+ *      Purpose: A vector of records that keeps each field in an array of its own (a "struct of arrays"), so that a pass over one
+ *      field reads only that field's memory rather than stepping over all the others.
+ */
+
+#ifndef COLUMN_VECTOR_H
+#define COLUMN_VECTOR_H
+
+#include "Vector.h"
+
+// The columns, one Vector per field, nested one inside the next. Each of the operations here is done to the first column and then
+// passed on to the rest, with the empty specialisation below bringing it to an end.
+template <class... Types> struct ColumnVectorColumns;
+
+template <> struct ColumnVectorColumns<>
+{
+    bool Reserve(int) { return true; }
+    bool ShrinkToFit() { return true; }
+    int Capacity() const { return (int)(~0U >> 1); }
+    void Resize(int) { }
+    bool PushBack() { return true; }
+    void Erase(int, int) { }
+    void EraseUnordered(int) { }
+    void PopBack() { }
+    void Clear() { }
+};
+
+template <class Type, class... Rest> struct ColumnVectorColumns<Type, Rest...>
+{
+    Vector<Type> column;
+    ColumnVectorColumns<Rest...> rest;
+
+    // This and PushBack are the only ones that can fail. If any column can't make room then the ones before it that grew are shrunk
+    // to fit their elements, to hand the memory back. That's a reallocation of its own, which can fail and leave a column bigger, and
+    // it can leave one with less room than it had before the Reserve. Either way the elements are untouched, and Capacity() is the
+    // smallest of the columns' so it never claims room that one of them doesn't have.
+    bool Reserve(int size)
+    {
+        int capacity = column.Capacity();
+
+        if(!column.Reserve(size))
+            return false;
+
+        if(!rest.Reserve(size))
+        {
+            if(column.Capacity() != capacity)
+                column.ShrinkToFit();
+
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ShrinkToFit()
+    {
+        bool shrunk = column.ShrinkToFit();
+        return rest.ShrinkToFit() && shrunk;
+    }
+
+    // The least room any of the columns has
+    int Capacity() const { return MIN(column.Capacity(), rest.Capacity()); }
+
+    // Everything from here on is only called once there's room for it, so none of it should fail
+    void Resize(int size)
+    {
+        column.Resize(size);
+        rest.Resize(size);
+    }
+
+    // If a later column can't take its value then this one's is taken back off, so the columns never end up different sizes
+    bool PushBack(const Type &value, const Rest&... values)
+    {
+        if(!column.PushBack(value))
+            return false;
+
+        if(!rest.PushBack(values...))
+        {
+            column.PopBack();
+            return false;
+        }
+
+        return true;
+    }
+
+    void Erase(int first, int last)
+    {
+        column.Erase(first, last);
+        rest.Erase(first, last);
+    }
+
+    void EraseUnordered(int position)
+    {
+        column.EraseUnordered(position);
+        rest.EraseUnordered(position);
+    }
+
+    void PopBack()
+    {
+        column.PopBack();
+        rest.PopBack();
+    }
+
+    void Clear()
+    {
+        column.Clear();
+        rest.Clear();
+    }
+};
+
+// Finds the Index'th column, and the type of its elements
+template <int Index, class... Types> struct ColumnVectorColumn;
+
+template <class Type, class... Rest> struct ColumnVectorColumn<0, Type, Rest...>
+{
+    typedef Type type;
+
+    static Vector<Type> &Get(ColumnVectorColumns<Type, Rest...> &columns) { return columns.column; }
+    static const Vector<Type> &Get(const ColumnVectorColumns<Type, Rest...> &columns) { return columns.column; }
+};
+
+template <int Index, class Type, class... Rest> struct ColumnVectorColumn<Index, Type, Rest...>
+{
+    typedef typename ColumnVectorColumn<Index - 1, Rest...>::type type;
+
+    static Vector<type> &Get(ColumnVectorColumns<Type, Rest...> &columns) { return ColumnVectorColumn<Index - 1, Rest...>::Get(columns.rest); }
+
+    static const Vector<type> &Get(const ColumnVectorColumns<Type, Rest...> &columns)
+    {
+        return ColumnVectorColumn<Index - 1, Rest...>::Get(columns.rest);
+    }
+};
+
+// Each of Types is a field, numbered from zero in the order they're given. The records go in and out whole, with PushBack taking one
+// value for each field, but each field is read through a column of its own:
+//
+//   ColumnVector<unsigned long, uint8_t, int> readings;   // timestamp, channel, value
+//   readings.PushBack(millis(), 2, analogRead(A2));
+//
+//   long sum = 0;
+//   for(int value : readings.Column<2>())
+//     sum += value;
+//
+// The columns are always the same size. Anything that can run out of memory makes room in every column before it changes any of
+// them, so when it fails, all of them are left as they were.
+template <class... Types> class ColumnVector
+{
+    ColumnVectorColumns<Types...> columns;
+
+public:
+    // The type of the Index'th field
+    template <int Index> struct Field
+    {
+        typedef typename ColumnVectorColumn<Index, Types...>::type type;
+    };
+
+    ColumnVector(int initialSize = 0) { Resize(initialSize); }
+
+    // Adds a record to the back of the vector, one value for each field. Returns false if there wasn't enough memory for it, in which
+    // case the vector is left as it was.
+    bool PushBack(const Types&... values)
+    {
+        if(Size() == Capacity() && !columns.Reserve(VectorGrowDouble::Grow(Size(), Size() + 1)))
+            return false;
+
+        return columns.PushBack(values...);
+    }
+
+    void Erase(int position) { Erase(position, position + 1); }
+
+    // Erases the records from first up to last minus one, shuffling everything after them down
+    void Erase(int first, int last) { columns.Erase(first, last); }
+
+    // Erases the record at position by moving the last one into its place, which takes constant time but doesn't keep them in order
+    void EraseUnordered(int position) { columns.EraseUnordered(position); }
+
+    // Removes the last record
+    void PopBack() { columns.PopBack(); }
+
+    void Clear() { columns.Clear(); }
+
+    bool Empty() const { return Size() == 0; }
+
+    // Returns the Index'th field of the nth record without checking that there is one
+    template <int Index> typename Field<Index>::type &At(int n) { return Column<Index>().At(n); }
+    template <int Index> const typename Field<Index>::type &At(int n) const { return Column<Index>().At(n); }
+
+    // Returns a view of the Index'th field of every record. The elements can be changed through it but the number of them can't, and
+    // like any view it's only good until the vector next reallocates.
+    template <int Index> VectorView<typename Field<Index>::type> Column()
+    {
+        return ColumnVectorColumn<Index, Types...>::Get(columns).View();
+    }
+
+    template <int Index> VectorView<const typename Field<Index>::type> Column() const
+    {
+        return ColumnVectorColumn<Index, Types...>::Get(columns).View();
+    }
+
+    // Returns a pointer to the array holding the Index'th field, the nth record's being at [n]
+    template <int Index> typename Field<Index>::type *Data() { return ColumnVectorColumn<Index, Types...>::Get(columns).Data(); }
+    template <int Index> const typename Field<Index>::type *Data() const { return ColumnVectorColumn<Index, Types...>::Get(columns).Data(); }
+
+    // Returns the number of records the vector will hold before it needs resizing, which is the least room any column has
+    int Capacity() const { return columns.Capacity(); }
+
+    // Returns the number of records in the vector
+    int Size() const { return ColumnVectorColumn<0, Types...>::Get(columns).Size(); }
+
+    // Makes sure there's room for size records in every column. Returns false if the memory couldn't be found.
+    bool Reserve(int size) { return columns.Reserve(size); }
+
+    // Hands back any capacity beyond what the records need. Returns false if any column couldn't be shrunk.
+    bool ShrinkToFit() { return columns.ShrinkToFit(); }
+
+    // Resizes the vector, default constructing the fields of any new records. Returns false, leaving the size as it was, if the memory
+    // couldn't be found.
+    bool Resize(int size)
+    {
+        if(!columns.Reserve(size))
+            return false;
+
+        columns.Resize(size);
+
+        return true;
+    }
+};
+
+#endif // COLUMN_VECTOR_H
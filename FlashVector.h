@@ -0,0 +1,192 @@
+/*
+ * FlashVector.h
+ *
+ *      Purpose: A read-only vector over a constant array kept in flash (PROGMEM), so that lookup tables, waveforms and the like can
+ *      be used through the familiar interface without first being copied into RAM.
+ */
+
+#ifndef FLASH_VECTOR_H
+#define FLASH_VECTOR_H
+
+#include "Vector.h"
+
+// AVR and the ESP8266 keep PROGMEM out of the data address space, so it has to be read with the pgm_read / memcpy_P family. Everywhere
+// else (ARM, the ESP32, the desktop) flash is mapped in alongside RAM and a const array can be read like any other.
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define VECTOR_FLASH_READS
+#elif defined(ESP8266) || defined(ARDUINO_ARCH_ESP8266)
+#include <pgmspace.h>
+#define VECTOR_FLASH_READS
+#endif
+
+// Elements are read out of flash by value, one copy at a time, which is why only trivially copyable types will do. The array is given
+// to the constructor, which works out its length itself when it's handed the array directly:
+//
+//   const int sine[] PROGMEM = { 0, 49, 97, 141, 180, 212, 235, 250, 255 };
+//   FlashVector<int> table(sine);
+template <class VectorType> class FlashVector
+{
+    static_assert(VectorIsTriviallyCopyable<VectorType>::value, "Only trivially copyable types can be read out of flash");
+
+    // The first element of the array in flash and the number of elements in it
+    const VectorType *elements;
+    int len;
+
+public:
+    // Walks the elements in order for range-based for loops, reading each out of flash as it goes
+    class Iterator
+    {
+        const VectorType *element;
+
+    public:
+        Iterator(const VectorType *element) : element(element) { }
+
+        VectorType operator*() const { return Read(element); }
+
+        Iterator &operator++()
+        {
+            ++element;
+            return *this;
+        }
+
+        bool operator!=(const Iterator &other) const { return element != other.element; }
+        bool operator==(const Iterator &other) const { return element == other.element; }
+    };
+
+    FlashVector(const VectorType *elements, int len) : elements(elements), len(len) { }
+
+    template <int Length> FlashVector(const VectorType (&elements)[Length]) : elements(elements), len(Length) { }
+
+    // Calls functor with a copy of each element in turn
+    template <class Functor> void ForEach(Functor &&functor) const
+    {
+        for(int i = 0; i < len; i++)
+            functor(At(i));
+    }
+
+    // Checks the entire array to see whether a matching item exists
+    bool Contains(const VectorType &element) const { return Find(element) != -1; }
+
+    // Returns the index of the first element equal to element, or -1 if there isn't one
+    int Find(const VectorType &element) const { return FlashScan<VectorType>::Find(elements, len, element); }
+
+    // Returns the number of elements equal to element
+    int Count(const VectorType &element) const
+    {
+        int count = 0;
+
+        for(int i = 0; i < len; i++)
+            count += (At(i) == element);
+
+        return count;
+    }
+
+    // Copies len elements starting at first into array in RAM in one go, which is quicker than reading them one at a time. Returns the
+    // number actually copied, which is fewer than len if the end of the vector comes first.
+    int CopyTo(VectorType *array, int first, int len) const
+    {
+        if(first < 0 || first >= this->len)
+            return 0;
+
+        len = MIN(len, this->len - first);
+
+        if(len > 0)
+            Read(array, elements + first, len);
+
+        return MAX(len, 0);
+    }
+
+    bool Empty() const { return len == 0; }
+
+    // Returns a copy of the nth element, or a default constructed one if n is out of bounds
+    VectorType operator[](int n) const
+    {
+        if(n >= 0 && n < len)
+            return At(n);
+        else
+            return VectorType();
+    }
+
+    // Returns a copy of the nth element without checking that there is one
+    VectorType At(int n) const { return Read(elements + n); }
+
+    // Returns the address of the array in flash. On AVR and the ESP8266 that can't be dereferenced directly, it's for the _P functions.
+    const VectorType *Data() const { return elements; }
+
+    Iterator begin() const { return Iterator(elements); }
+    Iterator end() const { return Iterator(elements + len); }
+
+    int Size() const { return len; }
+
+private:
+
+    // Searches the array for a value. Bytes on the parts that need it go through memchr_P, which is as quick as a search of flash gets.
+    template <class Type, bool Bytes = VectorIsInteger<Type>::value && sizeof(Type) == 1> struct FlashScan
+    {
+        static int Find(const Type *array, int len, const Type &value)
+        {
+            for(int i = 0; i < len; i++)
+                if(Read(array + i) == value)
+                    return i;
+
+            return -1;
+        }
+    };
+
+#ifdef VECTOR_FLASH_READS
+    template <class Type> struct FlashScan<Type, true>
+    {
+        static int Find(const Type *array, int len, const Type &value)
+        {
+            if(len <= 0)
+                return -1;
+
+            const Type *found = (const Type*)memchr_P(array, (unsigned char)value, len);
+
+            return found ? found - array : -1;
+        }
+    };
+#endif
+
+    // Reads a single element out of flash. Elements the size of a byte, word or double word are loaded in one go, which saves the
+    // call to memcpy_P.
+    static VectorType Read(const VectorType *element)
+    {
+        VectorType value;
+
+#ifdef VECTOR_FLASH_READS
+        if(sizeof(VectorType) == 1)
+        {
+            uint8_t bits = pgm_read_byte(element);
+            memcpy(&value, &bits, 1);
+        }
+        else if(sizeof(VectorType) == 2)
+        {
+            uint16_t bits = pgm_read_word(element);
+            memcpy(&value, &bits, 2);
+        }
+        else if(sizeof(VectorType) == 4)
+        {
+            uint32_t bits = pgm_read_dword(element);
+            memcpy(&value, &bits, 4);
+        }
+        else
+#endif
+            Read(&value, element, 1);
+
+        return value;
+    }
+
+    // Copies len elements out of flash into RAM
+    static void Read(VectorType *destination, const VectorType *source, int len)
+    {
+#ifdef VECTOR_FLASH_READS
+        memcpy_P(destination, source, sizeof(VectorType) * len);
+#else
+        memcpy(destination, source, sizeof(VectorType) * len);
+#endif
+    }
+};
+
+#endif // FLASH_VECTOR_H
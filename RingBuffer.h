@@ -0,0 +1,234 @@
+/*
+ * RingBuffer.h
+ *
+ *      Purpose: A fixed capacity first-in first-out buffer. Elements are pushed onto the back and popped off the front, both in
+ *      constant time, with the storage wrapping around from the end of its array back to the start.
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "Vector.h"
+
+// Like StaticVector the elements live in an array inside the object so nothing comes from the heap. When the buffer is full PushBack
+// either fails (the default) or, if Overwrite is true, makes room by dropping the oldest elements.
+//
+// Since elements go in at the back and come out of the front, Front() here is the oldest element and Back() the newest - which is the
+// other way around to Vector.
+template <class VectorType, int VectorCapacity, bool Overwrite = false> class RingBuffer
+{
+    // The underlying array, which the elements wrap around
+    VectorType elements[VectorCapacity];
+    // The index into the array of the oldest element - the tail
+    int tail;
+    // The number of elements in the buffer, the newest one being count - 1 places on from the tail
+    int count;
+
+public:
+    // The value that is returned when the caller asks for an element that is out of the bounds of the buffer
+#ifdef VECTOR_SHARED_OB
+    static VectorType OB;
+#else
+    VectorType OB;
+#endif
+
+    RingBuffer() : tail(0), count(0) { }
+
+    void ForEach(Predicate<VectorType> &functor)
+    {
+        for(int i = 0; i < count; i++)
+            functor(At(i));
+    }
+
+    // The same as above but for lambdas and any other functor that can be called with a VectorType&, which the compiler can inline
+    template <class Functor> typename VectorEnableIf<!VectorIsPredicate<Functor, VectorType>::value>::type ForEach(Functor &&functor)
+    {
+        int len;
+        VectorType *segment = FirstSegment(len);
+
+        for(int i = 0; i < len; i++)
+            functor(segment[i]);
+
+        segment = SecondSegment(len);
+
+        for(int i = 0; i < len; i++)
+            functor(segment[i]);
+    }
+
+    // Checks the entire buffer to see whether a matching item exists
+    bool Contains(const VectorType &element) const { return Find(element) != -1; }
+
+    // Returns how far from the front the first matching element is, or -1 if there isn't one. Each of the two runs the elements are
+    // laid out in is searched in one go.
+    int Find(const VectorType &element) const
+    {
+        int first = MIN(count, Capacity() - tail), found = VectorScan<VectorType>::Find(elements + tail, first, element);
+
+        if(found != -1)
+            return found;
+
+        found = VectorScan<VectorType>::Find(elements, count - first, element);
+
+        return found == -1 ? -1 : first + found;
+    }
+
+    // Returns the number of elements equal to element
+    int Count(const VectorType &element) const
+    {
+        int first = MIN(count, Capacity() - tail);
+
+        return VectorScan<VectorType>::Count(elements + tail, first, element) + VectorScan<VectorType>::Count(elements, count - first, element);
+    }
+
+    // Adds an element to the back of the buffer. If there's no room for it then it either replaces the oldest element (if Overwrite
+    // is set) or isn't added at all and this returns false.
+    bool PushBack(const VectorType &element)
+    {
+        if(Full())
+        {
+            if(!Overwrite)
+                return false;
+
+            PopFront();
+        }
+
+        elements[Wrap(tail + count)] = element;
+        count++;
+
+        return true;
+    }
+
+    // Adds len elements to the back of the buffer. Unless Overwrite is set, either all of them are added or (if there isn't room)
+    // none of them are and this returns false. With Overwrite set the oldest elements make way, so if len is more than the capacity
+    // only the last Capacity() elements of the array end up in the buffer.
+    bool PushBack(const VectorType *elements, int len)
+    {
+        if(len > Capacity() - count)
+        {
+            if(!Overwrite)
+                return false;
+
+            if(len > Capacity())
+            {
+                elements += len - Capacity();
+                len = Capacity();
+            }
+
+            PopFront(NULL, len - (Capacity() - count));
+        }
+
+        // Copy the data starting at the head all the way up to the last element of the array
+        int head = Wrap(tail + count), append = MIN(Capacity() - head, len), prepend = len - append;
+
+        VectorCopier<VectorType>::Copy(this->elements + head, elements, append);
+
+        // If there's still data to copy then whatever remains wraps around to the start of the array. The check above will have
+        // ensured that we don't crash into the tail during this process.
+        VectorCopier<VectorType>::Copy(this->elements, elements + append, prepend);
+
+        count += len;
+
+        return true;
+    }
+
+    // Removes the oldest element from the buffer
+    void PopFront()
+    {
+        if(count > 0)
+        {
+            tail = Wrap(tail + 1);
+            count--;
+        }
+    }
+
+    // Removes up to len of the oldest elements from the buffer, copying them to elements along the way unless it's NULL. Returns the
+    // number of elements that were actually removed.
+    int PopFront(VectorType *elements, int len)
+    {
+        len = MIN(len, count);
+
+        if(elements)
+        {
+            int append = MIN(Capacity() - tail, len);
+
+            VectorCopier<VectorType>::Copy(elements, this->elements + tail, append);
+            VectorCopier<VectorType>::Copy(elements + append, this->elements, len - append);
+        }
+
+        tail = Wrap(tail + len);
+        count -= len;
+
+        return len;
+    }
+
+    // Removes the newest element from the buffer
+    void PopBack()
+    {
+        if(count > 0)
+            count--;
+    }
+
+    // Empty the buffer, or to be precise - forget the fact that there was ever anything in there.
+    void Clear()
+    {
+        tail = 0;
+        count = 0;
+    }
+
+    // Returns a bool indicating whether or not there are any elements in the buffer
+    bool Empty() const { return count == 0; }
+
+    // Returns a bool indicating whether or not there's room for any more elements
+    bool Full() const { return count == Capacity(); }
+
+    // Returns the oldest element in the buffer (the next one to be popped)
+    VectorType const &Front() { return elements[tail]; }
+
+    // Returns the newest element in the buffer (the one most recently pushed)
+    VectorType const &Back() { return At(count - 1); }
+
+    // Returns the nth oldest element in the buffer, so [0] is the front
+    VectorType &operator[](int n)
+    {
+        if(n >= 0 && n < count)
+            return At(n);
+        else
+            return OB;
+    }
+
+    // Returns the nth oldest element without checking that there is one, so it's up to the caller to be sure that n is less than Size()
+    VectorType &At(int n) { return elements[Wrap(tail + n)]; }
+    const VectorType &At(int n) const { return elements[Wrap(tail + n)]; }
+
+    // The elements of the buffer are laid out in (at most) two runs in the underlying array: from the front up to the end of the array,
+    // then whatever wrapped around to the start. These return each run along with its length so they can be read in bulk, there's
+    // nothing in the second one unless the elements have wrapped.
+    VectorType *FirstSegment(int &len)
+    {
+        len = MIN(count, Capacity() - tail);
+        return elements + tail;
+    }
+
+    VectorType *SecondSegment(int &len)
+    {
+        len = count - MIN(count, Capacity() - tail);
+        return elements;
+    }
+
+    // Returns the number of elements that the buffer will hold, which is fixed at compile time
+    int Capacity() const { return VectorCapacity; }
+
+    // Returns the number of elements in the buffer
+    int Size() const { return count; }
+
+private:
+
+    // Brings an index that may have run up to twice the capacity back into the underlying array
+    int Wrap(int index) const { return index >= VectorCapacity ? index - VectorCapacity : index; }
+};
+
+#ifdef VECTOR_SHARED_OB
+template <class VectorType, int VectorCapacity, bool Overwrite> VectorType RingBuffer<VectorType, VectorCapacity, Overwrite>::OB = VectorType();
+#endif
+
+#endif // RING_BUFFER_H
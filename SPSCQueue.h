@@ -0,0 +1,144 @@
+/*
+ * SPSCQueue.h
+ *
+ *      Purpose: A fixed capacity first-in first-out queue that one producer (an interrupt, say) and one consumer (loop(), say) can
+ *      use at the same time without disabling interrupts or taking any locks.
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include "Vector.h"
+
+// The smallest unsigned type that can hold Capacity, which is the furthest apart the indices ever get. Indices that fit in a byte are
+// the ones that AVR can read and write in a single instruction, which is what makes the queue safe there without a critical section.
+template <int Capacity, bool Byte = (Capacity <= 128), bool Word = (Capacity <= 32768)> struct SPSCQueueIndex { typedef uint32_t type; };
+template <int Capacity, bool Word> struct SPSCQueueIndex<Capacity, true, Word> { typedef uint8_t type; };
+template <int Capacity> struct SPSCQueueIndex<Capacity, false, true> { typedef uint16_t type; };
+
+// Only the producer may call PushBack and only the consumer PopFront, everything else can be called from either side. The queue
+// never allocates and never moves its elements about, so there's nothing for an interrupt to catch half done.
+//
+// Each side owns one index: the producer advances the head once the elements it's pushed are in place and the consumer advances the
+// tail once it's done with the ones it's popped. The indices run freely and are masked down to a position in the array, which is why
+// the capacity has to be a power of two. They're read and written with the compiler's atomic builtins so that, on a dual core part
+// like the ESP32 or RP2040, the elements are seen to arrive before the index that says they're there.
+template <class VectorType, int VectorCapacity> class SPSCQueue
+{
+    static_assert(VectorCapacity > 0 && (VectorCapacity & (VectorCapacity - 1)) == 0, "The capacity of an SPSCQueue has to be a power of two");
+
+#if defined(__AVR__)
+    static_assert(VectorCapacity <= 128, "AVR can only read and write the indices of an SPSCQueue of up to 128 elements in one go");
+#endif
+
+    typedef typename SPSCQueueIndex<VectorCapacity>::type Index;
+
+    // The underlying array, which the elements wrap around
+    VectorType elements[VectorCapacity];
+    // The number of elements ever pushed (written by the producer) and popped (written by the consumer), both wrapping round
+    Index head, tail;
+
+public:
+    SPSCQueue() : head(0), tail(0) { }
+
+    // Adds an element to the back of the queue, returning false if it's full. Producer only.
+    bool PushBack(const VectorType &element)
+    {
+        Index _head = Load(head, __ATOMIC_RELAXED);
+
+        if((Index)(_head - Load(tail, __ATOMIC_ACQUIRE)) == VectorCapacity)
+            return false;
+
+        elements[_head & (VectorCapacity - 1)] = element;
+        Store(head, (Index)(_head + 1));
+
+        return true;
+    }
+
+    // Adds as many of the len elements as there's room for to the back of the queue, all of which become visible to the consumer at
+    // once. Returns the number added. Producer only.
+    int PushBack(const VectorType *elements, int len)
+    {
+        // The room is worked out once up front, MIN would read the tail twice
+        Index _head = Load(head, __ATOMIC_RELAXED);
+        int room = VectorCapacity - (Index)(_head - Load(tail, __ATOMIC_ACQUIRE));
+
+        len = MIN(len, room);
+
+        if(len <= 0)
+            return 0;
+
+        // Copy from the head up to the end of the array, and whatever's left over to the start of it
+        int position = _head & (VectorCapacity - 1), append = MIN(VectorCapacity - position, len);
+
+        VectorCopier<VectorType>::Copy(this->elements + position, elements, append);
+        VectorCopier<VectorType>::Copy(this->elements, elements + append, len - append);
+
+        Store(head, (Index)(_head + len));
+
+        return len;
+    }
+
+    // Takes the oldest element off the front of the queue and puts it in element, returning false (and leaving element alone) if the
+    // queue is empty. Consumer only.
+    bool PopFront(VectorType &element)
+    {
+        Index _tail = Load(tail, __ATOMIC_RELAXED);
+
+        if(Load(head, __ATOMIC_ACQUIRE) == _tail)
+            return false;
+
+        element = elements[_tail & (VectorCapacity - 1)];
+        Store(tail, (Index)(_tail + 1));
+
+        return true;
+    }
+
+    // Takes up to len of the oldest elements off the front of the queue, copying them to elements along the way unless it's NULL.
+    // Returns the number taken. Consumer only.
+    int PopFront(VectorType *elements, int len)
+    {
+        Index _tail = Load(tail, __ATOMIC_RELAXED);
+        int available = (Index)(Load(head, __ATOMIC_ACQUIRE) - _tail);
+
+        len = MIN(len, available);
+
+        if(len <= 0)
+            return 0;
+
+        if(elements)
+        {
+            int position = _tail & (VectorCapacity - 1), append = MIN(VectorCapacity - position, len);
+
+            VectorCopier<VectorType>::Copy(elements, this->elements + position, append);
+            VectorCopier<VectorType>::Copy(elements + append, this->elements, len - append);
+        }
+
+        Store(tail, (Index)(_tail + len));
+
+        return len;
+    }
+
+    // Throws away everything in the queue. Consumer only, and anything the producer pushes meanwhile may or may not survive.
+    void Clear() { Store(tail, Load(head, __ATOMIC_ACQUIRE)); }
+
+    // Returns the number of elements in the queue. Seen from the other side that's only a snapshot, more may have been pushed or
+    // popped by the time it's returned.
+    int Size() const { return (int)(Index)(Load(head, __ATOMIC_ACQUIRE) - Load(tail, __ATOMIC_ACQUIRE)); }
+
+    bool Empty() const { return Size() == 0; }
+
+    bool Full() const { return Size() == VectorCapacity; }
+
+    // Returns the number of elements that the queue will hold, which is fixed at compile time
+    int Capacity() const { return VectorCapacity; }
+
+private:
+
+    static Index Load(const Index &index, int order) { return __atomic_load_n(&index, order); }
+
+    // Publishes a new value of one of the indices, after everything written beforehand
+    static void Store(Index &index, Index value) { __atomic_store_n(&index, value, __ATOMIC_RELEASE); }
+};
+
+#endif // SPSC_QUEUE_H
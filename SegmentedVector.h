@@ -0,0 +1,372 @@
+/*
+ * SegmentedVector.h
+ *
+ *      Purpose: A vector that grows a fixed size chunk at a time rather than by reallocating one big array, so it never needs a large
+ *      contiguous block of memory and its elements never move once they're in.
+ */
+
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H
+
+#include "Vector.h"
+
+// The elements are kept in chunks of ChunkSize elements each, with a table of pointers to the chunks. Element n is element
+// n % ChunkSize of chunk n / ChunkSize, so indexing is still O(1) (and just a shift and a mask if ChunkSize is a power of two). Growing
+// only ever allocates one more chunk, and the table of pointers, which is the only thing that's reallocated, is small. On a heap that's
+// fragmented with use that can be the difference between growing and running out of memory, and since nothing is ever moved the
+// address of an element stays good for as long as it's in the vector.
+//
+// The elements aren't in one array, so there's no Data(). Chunk(n, len) returns each chunk in turn instead, for working through them
+// in bulk, and begin()/end() walk all of them in order. Otherwise it works just like a Vector.
+template <class VectorType, int ChunkSize = 16, class Allocator = VectorHeapAllocator, class Growth = VectorGrowDouble> class SegmentedVector
+{
+    static_assert(ChunkSize > 0, "A SegmentedVector's chunks need room for at least one element");
+
+    // One pointer to the start of each chunk. Only the elements up to count are constructed, the rest of the chunks being raw memory.
+    Vector<VectorType*, Allocator, Growth> chunks;
+    // The number of elements in the vector
+    int count;
+    // Where the chunks come from
+    Allocator allocator;
+
+public:
+    // The value that is returned when the caller asks for an element that is out of the bounds of the vector
+#ifdef VECTOR_SHARED_OB
+    static VectorType OB;
+#else
+    VectorType OB;
+#endif
+
+    // Walks the elements in order, for range-based for loops
+    template <class ElementType, class Table> class BasicIterator
+    {
+        Table table;
+        int n;
+
+    public:
+        BasicIterator(Table table, int n) : table(table), n(n) { }
+
+        ElementType &operator*() const { return table[n / ChunkSize][n % ChunkSize]; }
+        ElementType *operator->() const { return &**this; }
+
+        BasicIterator &operator++()
+        {
+            n++;
+            return *this;
+        }
+
+        bool operator!=(const BasicIterator &other) const { return n != other.n; }
+        bool operator==(const BasicIterator &other) const { return n == other.n; }
+    };
+
+    typedef BasicIterator<VectorType, VectorType *const*> Iterator;
+    typedef BasicIterator<const VectorType, const VectorType *const*> ConstIterator;
+
+    SegmentedVector(int initialSize = 0, const Allocator &allocator = Allocator()) : chunks(allocator), count(0), allocator(allocator)
+    {
+        Resize(initialSize);
+    }
+
+    SegmentedVector(const SegmentedVector &obj) : chunks(obj.allocator), count(0), allocator(obj.allocator) { *this = obj; }
+
+    // Takes over obj's chunks, leaving it empty
+    SegmentedVector(SegmentedVector &&obj) : chunks(static_cast<Vector<VectorType*, Allocator, Growth>&&>(obj.chunks)), count(obj.count),
+                                             allocator(obj.allocator)
+    {
+        obj.count = 0;
+    }
+
+    ~SegmentedVector()
+    {
+        Clear();
+        FreeChunks(0);
+    }
+
+    SegmentedVector &operator=(const SegmentedVector &obj)
+    {
+        if(&obj != this)
+        {
+            Clear();
+
+            // If there isn't room for all of obj's elements then this is left empty
+            if(Reserve(obj.Size()))
+                for(; count < obj.Size(); count++)
+                    new (Address(count), VectorPlacement()) VectorType(obj.At(count));
+        }
+
+        return *this;
+    }
+
+    SegmentedVector &operator=(SegmentedVector &&obj)
+    {
+        if(&obj != this)
+        {
+            Clear();
+            FreeChunks(0);
+
+            chunks = static_cast<Vector<VectorType*, Allocator, Growth>&&>(obj.chunks);
+            count = obj.count;
+            allocator = obj.allocator;
+            obj.count = 0;
+        }
+
+        return *this;
+    }
+
+    void ForEach(Predicate<VectorType> &functor)
+    {
+        for(int i = 0; i < count; i++)
+            functor(At(i));
+    }
+
+    // The same as above but for lambdas and any other functor that can be called with a VectorType&, which the compiler can inline.
+    // It works through a chunk at a time, so the inner loop is a plain walk along an array.
+    template <class Functor> typename VectorEnableIf<!VectorIsPredicate<Functor, VectorType>::value>::type ForEach(Functor &&functor)
+    {
+        for(int n = 0; n < Chunks(); n++)
+        {
+            int len;
+            VectorType *chunk = Chunk(n, len);
+
+            for(int i = 0; i < len; i++)
+                functor(chunk[i]);
+        }
+    }
+
+    // Checks the entire vector to see whether a matching item exists
+    bool Contains(const VectorType &element) const { return Find(element) != -1; }
+
+    // Returns the index of the first element equal to element, or -1 if there isn't one. Each chunk is searched in one go.
+    int Find(const VectorType &element) const
+    {
+        for(int n = 0; n < Chunks(); n++)
+        {
+            int len;
+            const VectorType *chunk = Chunk(n, len);
+            int found = VectorScan<VectorType>::Find(chunk, len, element);
+
+            if(found != -1)
+                return n * ChunkSize + found;
+        }
+
+        return -1;
+    }
+
+    // Returns the number of elements equal to element
+    int Count(const VectorType &element) const
+    {
+        int matches = 0;
+
+        for(int n = 0; n < Chunks(); n++)
+        {
+            int len;
+            const VectorType *chunk = Chunk(n, len);
+
+            matches += VectorScan<VectorType>::Count(chunk, len, element);
+        }
+
+        return matches;
+    }
+
+    // Returns false if there wasn't enough memory to fit the element in, in which case the vector is left as it was
+    bool PushBack(const VectorType &element) { return EmplaceBack(element); }
+    bool PushBack(VectorType &&element) { return EmplaceBack(static_cast<VectorType&&>(element)); }
+
+    bool PushBack(const VectorType *elements, int len)
+    {
+        if(!Reserve(count + len))
+            return false;
+
+        for(int i = 0; i < len; i++)
+            new (Address(count++), VectorPlacement()) VectorType(elements[i]);
+
+        return true;
+    }
+
+    // Constructs a new element at the back of the vector, passing arguments on to its constructor. If the last chunk is full this
+    // allocates one more, the only allocation that growing ever takes.
+    template <class... Arguments> bool EmplaceBack(Arguments&&... arguments)
+    {
+        if(count == Capacity() && !AddChunk())
+            return false;
+
+        new (Address(count), VectorPlacement()) VectorType(VectorForward<Arguments>(arguments)...);
+        count++;
+
+        return true;
+    }
+
+    void Erase(unsigned int position) { Erase(position, position + 1); }
+
+    // Erases the elements from first up to last minus one, moving everything after them down to close the gap, which is O(n) just as
+    // it is in Vector
+    void Erase(int first, int last)
+    {
+        if(first >= last)
+            return;
+
+        VECTOR_STAT(VectorStats().erasedMoves += count - last);
+
+        for(int i = last; i < count; i++)
+            At(first + i - last) = static_cast<VectorType&&>(At(i));
+
+        for(int i = count - (last - first); i < count; i++)
+            At(i).~VectorType();
+
+        count -= last - first;
+    }
+
+    // Erases the element at position by moving the last element into its place, in constant time but without keeping them in order
+    void EraseUnordered(int position)
+    {
+        if(position < 0 || position >= count)
+            return;
+
+        if(position != count - 1)
+        {
+            VECTOR_STAT(VectorStats().erasedMoves++);
+            At(position) = static_cast<VectorType&&>(At(count - 1));
+        }
+
+        PopBack();
+    }
+
+    // Remove the most recent element in the vector. The chunk it was in is kept for the next one.
+    void PopBack()
+    {
+        if(count > 0)
+            At(--count).~VectorType();
+    }
+
+    // Empty the vector, destroying each of its elements but keeping hold of the chunks they were in
+    void Clear()
+    {
+        while(count > 0)
+            PopBack();
+    }
+
+    // Returns a bool indicating whether or not there are any elements in the vector
+    bool Empty() const { return count == 0; }
+
+    // Returns the oldest element in the vector (the one added before any other), as Vector does
+    VectorType const &Back() { return At(0); }
+
+    // Returns the newest element in the vector (the one added after every other), as Vector does
+    VectorType const &Front() { return At(count - 1); }
+
+    // Returns the nth element in the vector
+    VectorType &operator[](int n)
+    {
+        if(n >= 0 && n < count)
+            return At(n);
+        else
+            return OB;
+    }
+
+    // Returns the nth element without checking that there is one
+    VectorType &At(int n) { return *Address(n); }
+    const VectorType &At(int n) const { return chunks.At(n / ChunkSize)[n % ChunkSize]; }
+
+    // Returns the number of chunks that hold elements
+    int Chunks() const { return (count + ChunkSize - 1) / ChunkSize; }
+
+    // Returns the nth chunk, setting len to the number of elements in it - ChunkSize for all but the last
+    VectorType *Chunk(int n, int &len)
+    {
+        len = MIN(ChunkSize, count - n * ChunkSize);
+        return chunks.At(n);
+    }
+
+    const VectorType *Chunk(int n, int &len) const
+    {
+        len = MIN(ChunkSize, count - n * ChunkSize);
+        return chunks.At(n);
+    }
+
+    Iterator begin() { return Iterator(chunks.Data(), 0); }
+    Iterator end() { return Iterator(chunks.Data(), count); }
+    ConstIterator begin() const { return ConstIterator(chunks.Data(), 0); }
+    ConstIterator end() const { return ConstIterator(chunks.Data(), count); }
+
+    // Returns the number of elements the vector will hold before it needs another chunk
+    int Capacity() const { return chunks.Size() * ChunkSize; }
+
+    // Returns the number of elements in the vector
+    int Size() const { return count; }
+
+    // Makes sure there are enough chunks for size elements. Returns false if the memory couldn't be found, though any chunks that were
+    // found are kept.
+    bool Reserve(int size)
+    {
+        while(Capacity() < size)
+            if(!AddChunk())
+                return false;
+
+        return true;
+    }
+
+    // Frees any chunks that don't hold elements and shrinks the table of them to fit
+    bool ShrinkToFit()
+    {
+        FreeChunks(Chunks());
+
+        return chunks.ShrinkToFit();
+    }
+
+    // Resizes the vector, returning false (and leaving the size as it was) if the memory couldn't be found. Any new elements are
+    // default constructed and any that no longer fit are destroyed.
+    bool Resize(int size)
+    {
+        if(!Reserve(size))
+            return false;
+
+        for(; count < size; count++)
+            new (Address(count), VectorPlacement()) VectorType;
+
+        while(count > size)
+            PopBack();
+
+        return true;
+    }
+
+private:
+
+    VectorType *Address(int n) { return chunks.At(n / ChunkSize) + n % ChunkSize; }
+
+    // Allocates one more chunk onto the end of the table
+    bool AddChunk()
+    {
+        VectorType *chunk = (VectorType*)allocator.Allocate(sizeof(VectorType) * ChunkSize);
+
+        VECTOR_STAT(VectorStats().allocations += (chunk != NULL));
+        VECTOR_STAT(VectorStats().allocatedBytes += chunk ? sizeof(VectorType) * ChunkSize : 0);
+        VECTOR_STAT(VectorStats().failedAllocations += (chunk == NULL));
+
+        if(chunk && chunks.PushBack(chunk))
+            return true;
+
+        if(chunk)
+            allocator.Deallocate(chunk, sizeof(VectorType) * ChunkSize);
+
+        return false;
+    }
+
+    // Frees every chunk from the first'th on, which mustn't hold any elements
+    void FreeChunks(int first)
+    {
+        while(chunks.Size() > first)
+        {
+            VECTOR_STAT(VectorStats().freedBytes += sizeof(VectorType) * ChunkSize);
+
+            allocator.Deallocate(chunks.At(chunks.Size() - 1), sizeof(VectorType) * ChunkSize);
+            chunks.PopBack();
+        }
+    }
+};
+
+#ifdef VECTOR_SHARED_OB
+template <class VectorType, int ChunkSize, class Allocator, class Growth>
+VectorType SegmentedVector<VectorType, ChunkSize, Allocator, Growth>::OB = VectorType();
+#endif
+
+#endif // SEGMENTED_VECTOR_H
@@ -0,0 +1,188 @@
+/*
+ * SmallVector.h
+ *
+ *      Purpose: A Vector with room for its first few elements inside the object itself, which only goes to the heap once it
+ *      outgrows them.
+ */
+
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include "Vector.h"
+
+// The allocator that backs a SmallVector. It hands out the inline buffer whenever that's free and big enough, and passes anything else
+// on to Fallback (the heap, by default).
+template <class Fallback = VectorHeapAllocator> class SmallVectorAllocator
+{
+    // The SmallVector's inline buffer and its size in bytes
+    void *buffer;
+    size_t size;
+    // Whether the vector's elements are in the inline buffer at the moment
+    bool used;
+    // Where every other allocation goes
+    Fallback fallback;
+
+public:
+    SmallVectorAllocator(void *buffer, size_t size, const Fallback &fallback) : buffer(buffer), size(size), used(false), fallback(fallback) { }
+
+    // Returns the allocator that everything outside the inline buffer comes from, so that a copy can draw from the same place
+    Fallback &GetFallback() { return fallback; }
+    const Fallback &GetFallback() const { return fallback; }
+
+    void *Allocate(size_t bytes)
+    {
+        if(used || bytes > size)
+            return fallback.Allocate(bytes);
+
+        used = true;
+        return buffer;
+    }
+
+    void Deallocate(void *ptr, size_t bytes)
+    {
+        if(ptr == buffer)
+            used = false;
+        else
+            fallback.Deallocate(ptr, bytes);
+    }
+
+    // The inline buffer can change size within its own bytes. A block from Fallback is resized by Fallback, if it can, unless it would
+    // then fit in the inline buffer while that's free - the vector should move back in then, which it does through Allocate.
+    bool TryExpand(void *ptr, size_t oldBytes, size_t newBytes)
+    {
+        if(ptr == buffer)
+            return newBytes <= size;
+
+        return (used || newBytes > size) && VectorTryExpand(fallback, ptr, oldBytes, newBytes, 0);
+    }
+
+    // Anything in the inline buffer has to be moved out by the vector itself, so this only ever resizes blocks from Fallback
+    void *Reallocate(void *ptr, size_t oldBytes, size_t newBytes)
+    {
+        if(ptr == buffer || (!used && newBytes <= size))
+            return NULL;
+
+        return VectorReallocate(fallback, ptr, oldBytes, newBytes, 0);
+    }
+};
+
+// The inline buffer is kept in a base class of its own so it's there before the Vector base is constructed and handed a pointer to it
+template <class VectorType, int InlineCapacity> class SmallVectorStorage
+{
+protected:
+    alignas(VectorType) uint8_t inlineElements[sizeof(VectorType) * InlineCapacity];
+};
+
+// Up to InlineCapacity elements are kept inside the object, so a SmallVector that never holds more than that never touches the heap and
+// keeps its elements in the same cache line as the rest of it. Past that it grows onto the heap (or whatever Allocator says) like any
+// other Vector, and moves back in if ShrinkToFit finds that its elements fit again. Everything else works just as it does in Vector.
+template <class VectorType, int InlineCapacity, class Allocator = VectorHeapAllocator, class Growth = VectorGrowDouble>
+class SmallVector : private SmallVectorStorage<VectorType, InlineCapacity>,
+                    public Vector<VectorType, SmallVectorAllocator<Allocator>, Growth>
+{
+    typedef Vector<VectorType, SmallVectorAllocator<Allocator>, Growth> Base;
+
+public:
+    SmallVector(int initialSize = 0, const Allocator &allocator = Allocator())
+        : Base(SmallVectorAllocator<Allocator>(this->inlineElements, sizeof(this->inlineElements), allocator))
+    {
+        // Reserving the inline buffer's worth straight away means it's the first thing the allocator hands out
+        this->Reserve(MAX(initialSize, InlineCapacity));
+        this->Resize(initialSize);
+    }
+
+    // Builds the vector from a list of elements in braces, which go in the inline buffer if they fit
+    SmallVector(std::initializer_list<VectorType> list, const Allocator &allocator = Allocator()) : SmallVector(0, allocator)
+    {
+        Base::operator=(list);
+    }
+
+    // The copy gets an inline buffer of its own, the copy constructor of Vector would have pointed it at obj's. Anything past that
+    // comes from the same place as obj's does.
+    SmallVector(const SmallVector &obj) : SmallVector(0, obj.GetAllocator().GetFallback())
+    {
+        Base::operator=(obj);
+    }
+
+    SmallVector(SmallVector &&obj) : SmallVector(0, obj.GetAllocator().GetFallback())
+    {
+        *this = static_cast<SmallVector&&>(obj);
+    }
+
+    SmallVector &operator=(const SmallVector &obj)
+    {
+        Base::operator=(obj);
+
+        return *this;
+    }
+
+    SmallVector &operator=(std::initializer_list<VectorType> list)
+    {
+        Base::operator=(list);
+
+        return *this;
+    }
+
+    // Elements on the heap are taken over along with their array, like Vector does, but ones in obj's inline buffer have to stay
+    // there, so those are moved across one at a time. Either way obj is left empty, unless there isn't the room for its inline
+    // elements here, in which case neither vector changes.
+    SmallVector &operator=(SmallVector &&obj)
+    {
+        if(&obj == this)
+            return *this;
+
+        if(obj.IsInline())
+        {
+            // Reserve keeps the elements that are already here if it fails, so make the room before clearing them
+            if(!this->Reserve(obj.Size()))
+                return *this;
+
+            this->Clear();
+
+            for(int i = 0; i < obj.Size(); i++)
+                this->EmplaceBack(static_cast<VectorType&&>(obj.At(i)));
+
+            obj.Clear();
+        }
+        else
+        {
+            // Take gives this vector's own array back to the fallback it came from before taking obj's, so after that the only
+            // array here is one of obj's fallback's blocks, and nothing the old fallback handed out is still held. That makes it
+            // safe to replace the old fallback with obj's, which is where the array has to go back to.
+            this->Take(obj);
+            this->GetAllocator().GetFallback() = obj.GetAllocator().GetFallback();
+        }
+
+        return *this;
+    }
+
+    // Vector::Swap exchanges arrays, but one in an inline buffer can't change hands, so the contents go round through a temporary
+    // instead, by moves: an array on the heap still just changes hands and only inline elements are moved one by one. Each move is
+    // into a vector that has just been emptied, which still has at least its inline buffer's worth of room, so none of them allocates
+    // and the swap can't fail part way through.
+    void Swap(SmallVector &obj)
+    {
+        if(&obj == this)
+            return;
+
+        SmallVector tmp(static_cast<SmallVector&&>(obj));
+
+        obj = static_cast<SmallVector&&>(*this);
+        *this = static_cast<SmallVector&&>(tmp);
+    }
+
+    // Hands back capacity beyond what the elements need. If they fit in the inline buffer then that's where they go, with the
+    // buffer's full capacity to grow into before the heap is needed again.
+    bool ShrinkToFit()
+    {
+        if(this->Size() > InlineCapacity)
+            return Base::ShrinkToFit();
+
+        return IsInline() || this->ReAllocate(InlineCapacity);
+    }
+
+    // Returns whether the elements are in the inline buffer at the moment, rather than on the heap
+    bool IsInline() const { return this->Data() == (const VectorType*)this->inlineElements; }
+};
+
+#endif // SMALL_VECTOR_H
@@ -0,0 +1,126 @@
+/*
+ * SortedVector.h
+ *
+ *      Purpose: A Vector that keeps its elements in order as they're inserted, so that finding one is a binary search.
+ */
+
+#ifndef SORTED_VECTOR_H
+#define SORTED_VECTOR_H
+
+#include "Vector.h"
+
+// The elements are kept sorted by Compare (operator< by default) so, unlike a Vector, they can't be changed in place - the only ways in
+// are Insert and Assign, and the elements can only be read. Lookups with Find, Contains, LowerBound and UpperBound take O(log n).
+template <class VectorType, class Compare = VectorLess, class Allocator = VectorHeapAllocator, class Growth = VectorGrowDouble> class SortedVector
+{
+    // The elements themselves, in order
+    Vector<VectorType, Allocator, Growth> elements;
+    // What decides that order
+    Compare compare;
+
+public:
+    SortedVector(const Compare &compare = Compare(), const Allocator &allocator = Allocator()) : elements(allocator), compare(compare) { }
+
+    // Inserts element after any that are equal to it so the vector stays sorted. Returns the position it ended up at, or -1 if there
+    // wasn't enough memory.
+    int Insert(const VectorType &element)
+    {
+        int position = elements.UpperBound(element, compare);
+
+        return elements.Insert(position, element) ? position : -1;
+    }
+
+    // The same as above except that if there's an element equal to this one already then nothing is inserted and its position is
+    // returned instead
+    int InsertUnique(const VectorType &element)
+    {
+        int position = elements.LowerBound(element, compare);
+
+        if(position < Size() && !compare(element, elements.At(position)))
+            return position;
+
+        return elements.Insert(position, element) ? position : -1;
+    }
+
+    // Replaces the contents of the vector with a copy of the len elements at array, sorted. Returns false if there wasn't enough memory.
+    bool Assign(const VectorType *array, int len)
+    {
+        if(!elements.Assign(array, len))
+            return false;
+
+        elements.Sort(compare);
+
+        return true;
+    }
+
+    // Returns the index of an element equal to element, or -1 if there isn't one
+    int Find(const VectorType &element) const { return elements.FindSorted(element, compare); }
+
+    bool Contains(const VectorType &element) const { return Find(element) != -1; }
+
+    // Returns the index of the first element not less than element, which is where it'd be inserted, or Size() if there isn't one
+    int LowerBound(const VectorType &element) const { return elements.LowerBound(element, compare); }
+
+    // Returns the index of the first element greater than element, or Size() if there isn't one
+    int UpperBound(const VectorType &element) const { return elements.UpperBound(element, compare); }
+
+    // Since erasing never puts anything out of order, these are just as they are in Vector
+    void Erase(unsigned int position) { elements.Erase(position); }
+    void Erase(int first, int last) { elements.Erase(first, last); }
+
+    // Erases every element equal to element, returning how many there were
+    int EraseAll(const VectorType &element)
+    {
+        int first = LowerBound(element), last = UpperBound(element);
+
+        if(first == last)
+            return 0;
+
+        elements.Erase(first, last);
+
+        return last - first;
+    }
+
+    // Erases all but one of each value, returning how many were erased
+    int Unique() { return elements.Unique(compare); }
+
+    template <class Functor> void ForEach(Functor &&functor) const
+    {
+        for(const VectorType *element = begin(); element != end(); ++element)
+            functor(*element);
+    }
+
+    // Remove the largest element
+    void PopBack() { elements.PopBack(); }
+
+    void Clear() { elements.Clear(); }
+
+    bool Empty() const { return elements.Empty(); }
+
+    // Returns the smallest element
+    VectorType const &Front() const { return elements.At(0); }
+
+    // Returns the largest element
+    VectorType const &Back() const { return elements.At(Size() - 1); }
+
+    // Returns the nth smallest element, or the OB member of the underlying vector if n is out of bounds
+    VectorType const &operator[](int n) { return elements[n]; }
+
+    // Returns the nth smallest element without checking that there is one
+    VectorType const &At(int n) const { return elements.At(n); }
+
+    const VectorType *Data() const { return elements.Data(); }
+
+    const VectorType *begin() const { return elements.begin(); }
+    const VectorType *end() const { return elements.end(); }
+
+    int Capacity() const { return elements.Capacity(); }
+
+    int Size() const { return elements.Size(); }
+
+    bool Reserve(unsigned int size) { return elements.Reserve(size); }
+
+    bool ShrinkToFit() { return elements.ShrinkToFit(); }
+};
+
+#endif // SORTED_VECTOR_H
@@ -0,0 +1,359 @@
+/*
+ * StaticVector.h
+ *
+ *      Purpose: A Vector whose elements live inside the object itself in an array of Capacity elements, fixed at compile time.
+ *      Nothing is ever taken from the heap, so the RAM it uses is known once the sketch links.
+ */
+
+#ifndef STATIC_VECTOR_H
+#define STATIC_VECTOR_H
+
+#include "Vector.h"
+
+template <class VectorType, int VectorCapacity> class StaticVector
+{
+    // The underlying array, it's part of the object so the vector never needs to allocate anything
+    VectorType elements[VectorCapacity];
+    // The index of the most recent element put in the underlying array - the head
+    int head;
+
+public:
+    // The value that is returned when the caller asks for an element that is out of the bounds of the vector
+#ifdef VECTOR_SHARED_OB
+    static VectorType OB;
+#else
+    VectorType OB;
+#endif
+
+    StaticVector() : head(-1) { }
+
+    // Builds the vector from its elements, given in braces. It's constexpr, so with constant elements the compiler lays the whole
+    // vector out itself and there's nothing to copy in when the sketch starts:
+    //
+    //   constexpr StaticVector<int, 8> pins = { 2, 3, 5, 7 };
+    //
+    // The rest of the array is zeroed (or default constructed), and more elements than the capacity won't compile.
+    template <class... Values> constexpr StaticVector(const VectorType &first, const VectorType &second, const Values&... rest)
+        : elements{ first, second, VectorType(rest)... }, head(sizeof...(Values) + 1)
+#ifndef VECTOR_SHARED_OB
+        , OB()
+#endif
+    {
+        static_assert(sizeof...(Values) + 1 < VectorCapacity, "There are more elements than the StaticVector has room for");
+    }
+
+    // A vector holding just element. Unlike Vector(5), which holds five default elements, StaticVector(5) holds a single 5, so this
+    // one is explicit: a lone value never turns into a StaticVector by accident, and a one element list has to be written
+    // StaticVector<int, 8> pins{ 2 } rather than with an =.
+    explicit constexpr StaticVector(const VectorType &element)
+        : elements{ element }, head(0)
+#ifndef VECTOR_SHARED_OB
+        , OB()
+#endif
+    {
+    }
+
+    void ForEach(Predicate<VectorType> &functor)
+    {
+        for(int i = 0; i < Size(); i++)
+            functor(elements[i]);
+    }
+
+    // The same as above but for lambdas and any other functor that can be called with a VectorType&, which the compiler can inline
+    template <class Functor> typename VectorEnableIf<!VectorIsPredicate<Functor, VectorType>::value>::type ForEach(Functor &&functor)
+    {
+        for(VectorType *element = begin(); element != end(); ++element)
+            functor(*element);
+    }
+
+    // Replaces each element with the result of calling functor on it
+    template <class Functor> void Transform(Functor &&functor)
+    {
+        for(VectorType *element = begin(); element != end(); ++element)
+            *element = functor(*element);
+    }
+
+    // Returns the number of elements for which functor returns true
+    template <class Functor> int CountIf(Functor &&functor) const
+    {
+        int count = 0;
+
+        for(const VectorType *element = begin(); element != end(); ++element)
+            if(functor(*element))
+                count++;
+
+        return count;
+    }
+
+    // Returns the index of the first element for which functor returns true, or -1 if there isn't one
+    template <class Functor> int FindIf(Functor &&functor) const
+    {
+        for(int i = 0; i < Size(); i++)
+            if(functor(elements[i]))
+                return i;
+
+        return -1;
+    }
+
+    // Erases every element for which functor returns true in a single pass, keeping the rest in order. Returns how many were erased.
+    template <class Functor> int RemoveIf(Functor &&functor)
+    {
+        int size = Size();
+
+        head = VectorCompact(elements, size, functor) - 1;
+
+        return size - Size();
+    }
+
+    // Swaps the contents of this vector with another of the same type. Unlike Vector::Swap there's no pointer to exchange here so
+    // this has to swap the elements themselves, one by one.
+    void Swap(StaticVector &obj)
+    {
+        for(int i = 0; i < MAX(Size(), obj.Size()); i++)
+        {
+            VectorType tmp = elements[i];
+            elements[i] = obj.elements[i];
+            obj.elements[i] = tmp;
+        }
+
+        SWAP(int, head, obj.head);
+    }
+
+    // Checks the entire vector to see whether a matching item exists. Bear in mind that the VectorType might need to implement
+    // equality operator (operator==) for this to work properly.
+    bool Contains(const VectorType &element) const { return Find(element) != -1; }
+
+    // Returns the index of the first element equal to element, or -1 if there isn't one
+    int Find(const VectorType &element) const { return VectorScan<VectorType>::Find(elements, Size(), element); }
+
+    // Returns the number of elements equal to element
+    int Count(const VectorType &element) const { return VectorScan<VectorType>::Count(elements, Size(), element); }
+
+    // Returns the sum of the elements, added up in a wider type for integers just as Vector's is
+    typename VectorAccumulator<VectorType>::type Sum() const { return VectorReduce<VectorType>::Sum(elements, Size()); }
+
+    // Returns the smallest element, or a default constructed one if there aren't any
+    VectorType Min() const { return Size() ? VectorReduce<VectorType>::Min(elements, Size()) : VectorType(); }
+
+    // Returns the largest element, or a default constructed one if there aren't any
+    VectorType Max() const { return Size() ? VectorReduce<VectorType>::Max(elements, Size()) : VectorType(); }
+
+    // Finds the smallest and largest elements in one pass. Returns false, leaving min and max alone, if there aren't any.
+    bool MinMax(VectorType &min, VectorType &max) const
+    {
+        if(!Size())
+            return false;
+
+        VectorReduce<VectorType>::MinMax(elements, Size(), min, max);
+
+        return true;
+    }
+
+    // Returns the average of the elements, or zero if there aren't any
+    double Mean() const { return Size() ? (double)Sum() / Size() : 0; }
+
+    // Returns the sum of the products of each element and the one at the same index in other (a Vector, a StaticVector or a view of
+    // the same type), leaving out any elements past the end of the shorter one
+    template <class Container> typename VectorAccumulator<VectorType>::type Dot(const Container &other) const
+    {
+        return VectorReduce<VectorType>::Dot(elements, other.Data(), MIN(Size(), other.Size()));
+    }
+
+    // Sorts the vector in place, by operator< unless it's given some other comparison
+    template <class Compare = VectorLess> void Sort(Compare compare = Compare()) { VectorSort(elements, Size(), compare); }
+
+    // Binary searches for when the vector is sorted by the same comparison, these work just like Vector's
+    template <class Compare = VectorLess> int LowerBound(const VectorType &value, Compare compare = Compare()) const
+    {
+        return VectorLowerBound(elements, Size(), value, compare);
+    }
+
+    template <class Compare = VectorLess> int UpperBound(const VectorType &value, Compare compare = Compare()) const
+    {
+        return VectorUpperBound(elements, Size(), value, compare);
+    }
+
+    template <class Compare = VectorLess> int FindSorted(const VectorType &value, Compare compare = Compare()) const
+    {
+        return VectorFindSorted(elements, Size(), value, compare);
+    }
+
+    // Returns false and leaves the vector as it was if there's no room left for the element
+    bool PushBack(const VectorType &element)
+    {
+        if(Full())
+            return false;
+
+        elements[++head] = element;
+
+        return true;
+    }
+
+    // Either all len elements are added or, if they won't fit, none of them are and this returns false
+    bool PushBack(const VectorType *elements, int len) { return Insert(Size(), elements, len); }
+
+    // Builds a new element at the back from the given constructor arguments. Since the array's elements are always there, this
+    // assigns a newly constructed VectorType over the one after the head.
+    template <class... Arguments> bool EmplaceBack(Arguments&&... arguments)
+    {
+        if(Full())
+            return false;
+
+        elements[++head] = VectorType(VectorForward<Arguments>(arguments)...);
+
+        return true;
+    }
+
+    // Inserts element so that it ends up at the given position, moving everything from there on up by one. Returns false if position
+    // is past the end of the vector or it's full.
+    bool Insert(int position, VectorType element) { return Insert(position, &element, 1); }
+
+    // Inserts len elements starting at the given position, moving everything from there on up to make room. Either all of them are
+    // inserted or, if they won't fit, none of them are. The elements can't come from this vector itself.
+    bool Insert(int position, const VectorType *elements, int len)
+    {
+        if(position < 0 || position > Size() || len + Size() > Capacity())
+            return false;
+
+        VectorCopier<VectorType>::MoveUp(this->elements + position + len, this->elements + position, Size() - position);
+        VectorCopier<VectorType>::Copy(this->elements + position, elements, len);
+
+        head += len;
+
+        return true;
+    }
+
+    void Erase(unsigned int position) { Erase(position, position + 1); }
+
+    // Erase an arbitrary section of the vector from first up to last minus one.
+    void Erase(int first, int last)
+    {
+        if(first >= last)
+            return;
+
+        // Shuffle everything from last onwards down to first
+        VectorCopier<VectorType>::MoveDown(elements + first, elements + last, Size() - last);
+
+        // Adjust the head to reflect the new size
+        head -= last - first;
+    }
+
+    // Erases the element at position in constant time by moving the last element into its place, which doesn't keep them in order
+    void EraseUnordered(int position)
+    {
+        if(position < 0 || position >= Size())
+            return;
+
+        if(position != head)
+            elements[position] = static_cast<VectorType&&>(elements[head]);
+
+        head--;
+    }
+
+    // Erases every element equal to element in a single pass, keeping the rest in order. Returns how many were erased.
+    int EraseAll(const VectorType &element)
+    {
+        return RemoveIf([&element](const VectorType &candidate) { return candidate == element; });
+    }
+
+    // Remove the most recent element in the array
+    void PopBack()
+    {
+        if(Size() > 0)
+            head--;
+    }
+
+    // Empty the vector, or to be precise - forget the fact that there was ever anything in there.
+    void Clear() { head = -1; }
+
+    // Returns a bool indicating whether or not there are any elements in the array
+    constexpr bool Empty() const { return head == -1; }
+
+    // Returns a bool indicating whether or not there's room for any more elements
+    constexpr bool Full() const { return Size() == Capacity(); }
+
+    // Returns the oldest element in the array (the one added before any other)
+    VectorType const &Back() { return *elements; }
+
+    // Returns the newest element in the array (the one added after every other)
+    VectorType const &Front() { return elements[head]; }
+
+    // Returns the nth element in the vector
+    VectorType &operator[](int n)
+    {
+        if(n >= 0 && n < Size())
+            return elements[n];
+        else
+            return OB;
+    }
+
+    // Returns the nth element, or OB if it's out of bounds. This and the other const accessors are constexpr, so they can be used on a
+    // constexpr vector at compile time.
+    constexpr const VectorType &operator[](int n) const { return n >= 0 && n < Size() ? elements[n] : OB; }
+
+    // Returns the nth element without checking that there is one, so it's up to the caller to be sure that n is less than Size()
+    VectorType &At(int n) { return elements[n]; }
+    constexpr const VectorType &At(int n) const { return elements[n]; }
+
+    // Returns a pointer such that the vector's data is laid out between ret to ret + size
+    VectorType *Data() { return elements; }
+    constexpr const VectorType *Data() const { return elements; }
+
+    // Pointers to the first element and one past the last, for walking the vector with a pointer or a range-based for loop
+    VectorType *begin() { return elements; }
+    VectorType *end() { return elements + Size(); }
+    constexpr const VectorType *begin() const { return elements; }
+    constexpr const VectorType *end() const { return elements + Size(); }
+
+    // Recreates the vector to hold len elements, all being copies of val. Returns false if len is more than the capacity.
+    bool Assign(int len, const VectorType &val)
+    {
+        if(len > Capacity())
+            return false;
+
+        for(int i = 0; i < len; i++)
+            elements[i] = val;
+
+        head = len - 1;
+
+        return true;
+    }
+
+    // Recreates the vector using an external array. Returns false if len is more than the capacity.
+    bool Assign(const VectorType *array, int len)
+    {
+        if(len > Capacity())
+            return false;
+
+        Clear();
+
+        return PushBack(array, len);
+    }
+
+    // Returns the number of elements that the vector will support, which is fixed at compile time
+    constexpr int Capacity() const { return VectorCapacity; }
+
+    // Returns the number of elements in vector
+    constexpr int Size() const { return head + 1; }
+
+    // There's no allocating more storage for a StaticVector, this just reports whether size elements would fit
+    bool Reserve(unsigned int size) { return size <= (unsigned int)Capacity(); }
+
+    // Resizes the vector, returning false if size is more than the capacity
+    bool Resize(unsigned int size)
+    {
+        if(!Reserve(size))
+            return false;
+
+        head = size - 1;
+
+        return true;
+    }
+};
+
+#ifdef VECTOR_SHARED_OB
+template <class VectorType, int VectorCapacity> VectorType StaticVector<VectorType, VectorCapacity>::OB = VectorType();
+#endif
+
+#endif // STATIC_VECTOR_H
+
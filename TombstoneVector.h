@@ -0,0 +1,263 @@
+/*
+ * TombstoneVector.h
+ *
+ *      Purpose: A vector whose Erase just marks the element as gone, leaving the gaps to be closed up all at once later, so that erasing
+ *      lots of elements costs one pass over the vector rather than one pass for each of them.
+ */
+
+#ifndef TOMBSTONE_VECTOR_H
+#define TOMBSTONE_VECTOR_H
+
+#include "Vector.h"
+#include "BitVector.h"
+
+// The share of the slots (as a percentage) that have to be erased before adding another element closes up the gaps first
+#ifndef VECTOR_TOMBSTONE_THRESHOLD
+#define VECTOR_TOMBSTONE_THRESHOLD 25
+#endif
+
+// The elements are kept in a Vector alongside a BitVector with a bit for each of them, the bit being set once the element has been
+// erased (it's a "tombstone"). Erasing an element sets its bit and nothing else, so it takes constant time, and every slot keeps its
+// number. Compact() closes up the gaps in a single pass, keeping the elements that are left in order, at which point the elements
+// after each gap move down and get new numbers.
+//
+//   TombstoneVector<Particle> particles;
+//   for(int i = 0; i < particles.Slots(); i++)
+//     if(!particles.IsErased(i) && particles.At(i).Dead())
+//       particles.Erase(i);         // no shuffling, i still refers to the same slot afterwards
+//
+// Adding an element compacts the vector first if more than the threshold (VECTOR_TOMBSTONE_THRESHOLD percent by default) of the
+// slots are erased, so the gaps don't build up for ever, but slot numbers never change in the middle of a run of erases. Erased
+// elements are only destroyed when they're compacted away.
+template <class VectorType, class Allocator = VectorHeapAllocator, class Growth = VectorGrowDouble> class TombstoneVector
+{
+    // Every slot, erased or not
+    Vector<VectorType, Allocator, Growth> elements;
+    // The bit for each slot is set once it's been erased
+    BitVector<Allocator, Growth> erased;
+    // The number of erased slots
+    int tombstones;
+    // The percentage of the slots that are erased when adding an element compacts the vector
+    int threshold;
+
+public:
+    // The value that is returned when the caller asks for an element that is out of the bounds of the vector or has been erased
+#ifdef VECTOR_SHARED_OB
+    static VectorType OB;
+#else
+    VectorType OB;
+#endif
+
+    // Walks the elements that haven't been erased, in order, for range-based for loops
+    template <class ElementType, class Owner> class BasicIterator
+    {
+        Owner *owner;
+        int n;
+
+    public:
+        BasicIterator(Owner *owner, int n) : owner(owner), n(n) { Skip(); }
+
+        ElementType &operator*() const { return owner->At(n); }
+        ElementType *operator->() const { return &owner->At(n); }
+
+        BasicIterator &operator++()
+        {
+            n++;
+            Skip();
+            return *this;
+        }
+
+        bool operator!=(const BasicIterator &other) const { return n != other.n; }
+        bool operator==(const BasicIterator &other) const { return n == other.n; }
+
+    private:
+
+        void Skip()
+        {
+            while(n < owner->Slots() && owner->IsErased(n))
+                n++;
+        }
+    };
+
+    typedef BasicIterator<VectorType, TombstoneVector> Iterator;
+    typedef BasicIterator<const VectorType, const TombstoneVector> ConstIterator;
+
+    TombstoneVector(int initialSize = 0, const Allocator &allocator = Allocator())
+        : elements(allocator), erased(0, false, allocator), tombstones(0), threshold(VECTOR_TOMBSTONE_THRESHOLD)
+    {
+        Resize(initialSize);
+    }
+
+    void ForEach(Predicate<VectorType> &functor)
+    {
+        for(int i = 0; i < Slots(); i++)
+            if(!IsErased(i))
+                functor(elements.At(i));
+    }
+
+    // The same as above but for lambdas and any other functor that can be called with a VectorType&, which the compiler can inline
+    template <class Functor> typename VectorEnableIf<!VectorIsPredicate<Functor, VectorType>::value>::type ForEach(Functor &&functor)
+    {
+        for(int i = 0; i < Slots(); i++)
+            if(!IsErased(i))
+                functor(elements.At(i));
+    }
+
+    // Checks the vector to see whether an element equal to element exists that hasn't been erased
+    bool Contains(const VectorType &element) const { return Find(element) != -1; }
+
+    // Returns the slot of the first element equal to element that hasn't been erased, or -1 if there isn't one
+    int Find(const VectorType &element) const
+    {
+        for(int i = 0; i < Slots(); i++)
+            if(!IsErased(i) && elements.At(i) == element)
+                return i;
+
+        return -1;
+    }
+
+    // Returns the number of elements equal to element that haven't been erased
+    int Count(const VectorType &element) const
+    {
+        int matches = 0;
+
+        for(int i = 0; i < Slots(); i++)
+            if(!IsErased(i) && elements.At(i) == element)
+                matches++;
+
+        return matches;
+    }
+
+    // Adds an element in a new slot at the back, compacting the vector first if enough of it has been erased. Returns false if there
+    // wasn't enough memory for it, in which case the elements are left as they were (though they may have been compacted).
+    bool PushBack(const VectorType &element) { return EmplaceBack(element); }
+    bool PushBack(VectorType &&element) { return EmplaceBack(static_cast<VectorType&&>(element)); }
+
+    template <class... Arguments> bool EmplaceBack(Arguments&&... arguments)
+    {
+        if((long)tombstones * 100 > (long)Slots() * threshold)
+            Compact();
+
+        // Make room for the bit first, so that once the element is in there's nothing left that can fail
+        if(!erased.Reserve(Slots() + 1) || !elements.EmplaceBack(VectorForward<Arguments>(arguments)...))
+            return false;
+
+        erased.PushBack(false);
+
+        return true;
+    }
+
+    // Marks the element in slot as erased, in constant time. Nothing moves and every other slot keeps its number until the next
+    // Compact().
+    void Erase(int slot)
+    {
+        if(slot >= 0 && slot < Slots() && !IsErased(slot))
+        {
+            erased.Set(slot);
+            tombstones++;
+        }
+    }
+
+    // Closes up the gaps left by erased elements in a single pass, keeping the rest in order, and destroys the erased ones. Slots up to
+    // the first erased one are skipped over whole.
+    void Compact()
+    {
+        if(!tombstones)
+            return;
+
+        int first = erased.FindFirstSet();
+        VectorType *slots = elements.Data();
+        const BitVector<Allocator, Growth> &gone = erased;
+
+        auto isErased = [slots, &gone](const VectorType &element) { return gone.Get(&element - slots); };
+        int kept = first + VectorCompact(slots + first, Slots() - first, isErased);
+
+        // Both of these only ever shrink, so neither can fail
+        elements.Resize(kept);
+        erased.Resize(kept);
+        erased.Fill(false);
+
+        tombstones = 0;
+    }
+
+    // Sets the percentage of the slots that have to be erased before adding an element compacts the vector. 0 compacts before every
+    // addition that follows an erase, and 100 or more leaves it to Compact().
+    void SetThreshold(int percent) { threshold = percent; }
+
+    // Empties the vector, erased slots and all
+    void Clear()
+    {
+        elements.Clear();
+        erased.Clear();
+        tombstones = 0;
+    }
+
+    // Returns a bool indicating whether or not there are any elements left that haven't been erased
+    bool Empty() const { return Size() == 0; }
+
+    // Returns whether the element in slot has been erased
+    bool IsErased(int slot) const { return erased.Get(slot); }
+
+    // Returns the element in slot, or OB if it's out of bounds or has been erased
+    VectorType &operator[](int slot)
+    {
+        if(slot >= 0 && slot < Slots() && !IsErased(slot))
+            return elements.At(slot);
+        else
+            return OB;
+    }
+
+    // Returns the element in slot without checking that there is one, or that it hasn't been erased
+    VectorType &At(int slot) { return elements.At(slot); }
+    const VectorType &At(int slot) const { return elements.At(slot); }
+
+    Iterator begin() { return Iterator(this, 0); }
+    Iterator end() { return Iterator(this, Slots()); }
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, Slots()); }
+
+    // Returns the number of elements that haven't been erased
+    int Size() const { return Slots() - tombstones; }
+
+    // Returns the number of slots, erased or not, which is one more than the highest slot number
+    int Slots() const { return elements.Size(); }
+
+    // Returns the number of erased slots waiting to be compacted away
+    int Tombstones() const { return tombstones; }
+
+    // Returns the number of slots the vector will hold before it needs resizing
+    int Capacity() const { return elements.Capacity(); }
+
+    // Makes sure there's room for size slots. Returns false if the memory couldn't be found.
+    bool Reserve(int size) { return elements.Reserve(size) && erased.Reserve(size); }
+
+    // Compacts the vector and hands back any capacity beyond what's left
+    bool ShrinkToFit()
+    {
+        Compact();
+
+        bool shrunk = elements.ShrinkToFit();
+        return erased.ShrinkToFit() && shrunk;
+    }
+
+    // Compacts the vector and then resizes it to size elements, default constructing any new ones and destroying any that no longer
+    // fit. Returns false, leaving the size as it was, if the memory couldn't be found.
+    bool Resize(int size)
+    {
+        Compact();
+
+        if(!Reserve(size))
+            return false;
+
+        elements.Resize(size);
+        erased.Resize(size, false);
+
+        return true;
+    }
+};
+
+#ifdef VECTOR_SHARED_OB
+template <class VectorType, class Allocator, class Growth> VectorType TombstoneVector<VectorType, Allocator, Growth>::OB = VectorType();
+#endif
+
+#endif // TOMBSTONE_VECTOR_H
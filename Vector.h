@@ -13,6 +13,45 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "VectorReduce.h"
+#include "VectorScan.h"
+#include "VectorView.h"
+
+// Brace enclosed lists of elements arrive as a std::initializer_list, which the compiler builds itself but which lives in a header of
+// the standard library - and AVR boards don't have one. There it's declared here instead, laid out just as the compiler expects. That's
+// only done when the header is known to be missing: it's AVR, or __has_include says so. Compilers before GCC 5 have no __has_include
+// but do have the header (the Due's and the older ESP8266 cores' among them), and declaring it again there would clash with it.
+#if defined(__has_include)
+#if __has_include(<initializer_list>)
+#include <initializer_list>
+#define VECTOR_HAS_INITIALIZER_LIST
+#endif
+#elif !defined(__AVR__)
+#include <initializer_list>
+#define VECTOR_HAS_INITIALIZER_LIST
+#endif
+
+#ifndef VECTOR_HAS_INITIALIZER_LIST
+namespace std
+{
+    template <class Element> class initializer_list
+    {
+        const Element *array;
+        size_t len;
+
+        // Only the compiler ever calls this
+        constexpr initializer_list(const Element *array, size_t len) : array(array), len(len) { }
+
+    public:
+        constexpr initializer_list() : array(NULL), len(0) { }
+
+        constexpr size_t size() const { return len; }
+        constexpr const Element *begin() const { return array; }
+        constexpr const Element *end() const { return array + len; }
+    };
+}
+#endif
+
 #ifndef MIN
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #endif
@@ -23,54 +62,672 @@
 
 #define SWAP(type, a, b) type tmp ## a = a; a = b; b = tmp ## a;
 
+// Define VECTOR_STATS before including Vector.h to have every Vector keep count of what it allocates in VectorStats(). Left undefined,
+// none of the counting is compiled in and it costs nothing at all.
+#ifdef VECTOR_STATS
+
+// Called whenever a vector swaps its array for another, with the vector in question, its old and new capacities and the size of each
+// of its elements. Handy for finding out which vector it was that ate the heap.
+typedef void (*VectorReallocateCallback)(const void *vector, int oldCapacity, int newCapacity, size_t elementSize);
+
+struct VectorStatistics
+{
+    // The number of times a vector has swapped its array for another
+    unsigned long reallocations;
+    // The number of allocations made and the bytes they came to, along with the number of allocations that came back empty
+    unsigned long allocations, allocatedBytes, failedAllocations;
+    // The bytes given back to the allocators
+    unsigned long freedBytes;
+    // The number of elements that Erase has had to shuffle down to close up the gaps it left
+    unsigned long erasedMoves;
+    // The largest capacity any vector has been reallocated to
+    int peakCapacity;
+    // If set, this is called on every reallocation
+    VectorReallocateCallback onReallocate;
+
+    void Reset()
+    {
+        VectorReallocateCallback callback = onReallocate;
+
+        memset(this, 0, sizeof(*this));
+        onReallocate = callback;
+    }
+
+    void Reallocated(const void *vector, int oldCapacity, int newCapacity, size_t elementSize)
+    {
+        reallocations++;
+        peakCapacity = MAX(peakCapacity, newCapacity);
+
+        if(onReallocate)
+            onReallocate(vector, oldCapacity, newCapacity, elementSize);
+    }
+};
+
+// The statistics for every vector in the sketch
+inline VectorStatistics &VectorStats()
+{
+    static VectorStatistics stats;
+    return stats;
+}
+
+#define VECTOR_STAT(statement) statement
+
+#else
+
+#define VECTOR_STAT(statement)
+
+#endif
+
+// Every Vector has a virtual destructor so that deleting a class derived from one through a pointer to the Vector works. If nothing in
+// the sketch does that, defining VECTOR_NO_VIRTUAL before including Vector.h takes the destructor, and the pointer to a table of
+// virtual functions that comes with it, out of every vector.
+#ifdef VECTOR_NO_VIRTUAL
+#define VECTOR_VIRTUAL
+#else
+#define VECTOR_VIRTUAL virtual
+#endif
+
+// Each vector normally has an out of bounds value (OB) of its own, which for a vector of large structs can be bigger than everything
+// else in it. Defining VECTOR_SHARED_OB before including Vector.h makes OB a static member instead, shared by every Vector (and
+// StaticVector and RingBuffer) of the same type. Writes to it through one of them then show up through all the others, of course.
+
+// A placement new of our own, tagged so that it can't collide with the one from <new> on cores that have it (and is still there on
+// cores, like AVR, that don't). It's what lets a vector build its elements in memory it got from an allocator.
+struct VectorPlacement { };
+
+inline void *operator new(size_t, void *ptr, VectorPlacement) { return ptr; }
+inline void operator delete(void *, void *, VectorPlacement) { }
+
+// Whether a type's elements can be copied about with memcpy rather than one at a time. There's no <type_traits> on AVR but the compiler
+// knows well enough. If yours is too old to have the builtin, or you know better, specialise this for VectorType.
+template <class VectorType> struct VectorIsTriviallyCopyable
+{
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 5
+    static const bool value = __has_trivial_copy(VectorType) && __has_trivial_assign(VectorType) && __has_trivial_destructor(VectorType);
+#else
+    static const bool value = __is_trivially_copyable(VectorType);
+#endif
+};
+
+// The ways the containers in this library copy runs of elements about. This version does them one element at a time, for types that
+// need their constructors and operator= to run; the one below takes over for trivially copyable types.
+template <class VectorType, bool Trivial = VectorIsTriviallyCopyable<VectorType>::value> struct VectorCopier
+{
+    // Copy constructs len elements from source into the raw memory at destination
+    static void Construct(VectorType *destination, const VectorType *source, int len)
+    {
+        for(int i = 0; i < len; i++)
+            new (destination + i, VectorPlacement()) VectorType(source[i]);
+    }
+
+    // Assigns len elements from source over the existing elements at destination
+    static void Copy(VectorType *destination, const VectorType *source, int len)
+    {
+        for(int i = 0; i < len; i++)
+            destination[i] = source[i];
+    }
+
+    // Moves len elements from source into the raw memory at destination, destroying the originals as it goes
+    static void Relocate(VectorType *destination, VectorType *source, int len)
+    {
+        for(int i = 0; i < len; i++)
+        {
+            new (destination + i, VectorPlacement()) VectorType(static_cast<VectorType&&>(source[i]));
+            source[i].~VectorType();
+        }
+    }
+
+    // Moves len elements from source into destination, which comes after source and may overlap it. Everything in destination that
+    // isn't also in source has to be raw memory, and what's left of source once it's done is raw memory too.
+    static void RelocateUp(VectorType *destination, VectorType *source, int len)
+    {
+        // Working backwards from the end means each element is moved into memory that's either past the end of source or was
+        // vacated by an earlier move
+        for(int i = len - 1; i >= 0; i--)
+        {
+            new (destination + i, VectorPlacement()) VectorType(static_cast<VectorType&&>(source[i]));
+            source[i].~VectorType();
+        }
+    }
+
+    // Moves len elements from source down over the existing elements at destination, which has to come before source. Whatever
+    // is left behind at the end of the run still needs destroying.
+    static void MoveDown(VectorType *destination, VectorType *source, int len)
+    {
+        for(int i = 0; i < len; i++)
+            destination[i] = static_cast<VectorType&&>(source[i]);
+    }
+
+    // Moves len elements from source up over the existing elements at destination, which has to come after source
+    static void MoveUp(VectorType *destination, VectorType *source, int len)
+    {
+        for(int i = len - 1; i >= 0; i--)
+            destination[i] = static_cast<VectorType&&>(source[i]);
+    }
+};
+
+template <class VectorType> struct VectorCopier<VectorType, true>
+{
+    static void Construct(VectorType *destination, const VectorType *source, int len) { Copy(destination, source, len); }
+
+    static void Copy(VectorType *destination, const VectorType *source, int len)
+    {
+        if(len > 0)
+            memcpy(destination, source, sizeof(VectorType) * len);
+    }
+
+    static void Relocate(VectorType *destination, VectorType *source, int len) { Copy(destination, source, len); }
+
+    // The runs can overlap from here on so these need memmove rather than memcpy
+    static void RelocateUp(VectorType *destination, VectorType *source, int len) { MoveDown(destination, source, len); }
+
+    static void MoveDown(VectorType *destination, VectorType *source, int len)
+    {
+        if(len > 0)
+            memmove(destination, source, sizeof(VectorType) * len);
+    }
+
+    static void MoveUp(VectorType *destination, VectorType *source, int len) { MoveDown(destination, source, len); }
+};
+
+// Allocators hand vectors their raw memory. Anything with these two functions will do - have a look at VectorPool.h for one which
+// draws from a preallocated region rather than the heap. This one, the default, just goes to the heap like the vector always has.
+class VectorHeapAllocator
+{
+public:
+    // Returns a block of at least bytes bytes, or NULL if there isn't one to be had
+    void *Allocate(size_t bytes) { return malloc(bytes); }
+
+    // Gives back a block previously returned by Allocate, along with the number of bytes that were asked for at the time
+    void Deallocate(void *ptr, size_t) { free(ptr); }
+
+    // Resizes a block just as realloc does, extending it where it is if the memory after it is free and moving it if not. It's only
+    // used for vectors of trivially copyable types, since the bytes are just copied across.
+    void *Reallocate(void *ptr, size_t, size_t bytes) { return realloc(ptr, bytes); }
+};
+
+// Besides Allocate and Deallocate, an allocator can have either of these to save a vector from having its old array and a new one
+// allocated at the same time when it grows. TryExpand(ptr, oldBytes, newBytes) changes the size of a block without moving it,
+// returning false if it can't, and works for any type of element. Reallocate(ptr, oldBytes, newBytes) does what realloc does, returning
+// NULL (with the block left as it was) if it can't, and is only used for trivially copyable elements. A vector falls back on Allocate
+// when there isn't one, or it fails. These pick the hook when the allocator has it (the int argument choosing that overload) and do
+// without when it doesn't.
+template <class Allocator> auto VectorTryExpand(Allocator &allocator, void *ptr, size_t oldBytes, size_t newBytes, int)
+    -> decltype(allocator.TryExpand(ptr, oldBytes, newBytes))
+{
+    return allocator.TryExpand(ptr, oldBytes, newBytes);
+}
+
+template <class Allocator> bool VectorTryExpand(Allocator &, void *, size_t, size_t, long) { return false; }
+
+template <class Allocator> auto VectorReallocate(Allocator &allocator, void *ptr, size_t oldBytes, size_t newBytes, int)
+    -> decltype(allocator.Reallocate(ptr, oldBytes, newBytes))
+{
+    return allocator.Reallocate(ptr, oldBytes, newBytes);
+}
+
+template <class Allocator> void *VectorReallocate(Allocator &, void *, size_t, size_t, long) { return NULL; }
+
+// Growth policies decide how large the new array should be when a vector runs out of room. Each has a single function which is given
+// the number of elements in the vector and the number it needs to hold and returns the capacity to reallocate to, which must be at
+// least required. The default doubles the size, which keeps the number of reallocations down at the cost of up to half the capacity
+// going spare. The others trade some of that speed for memory, which on a part with only a couple of KB of RAM can make the
+// difference between a reallocation fitting and failing.
+struct VectorGrowDouble
+{
+    static int Grow(int size, int required) { return MAX(required, size * 2); }
+};
+
+// Grows the capacity by half as much again each time
+struct VectorGrowHalf
+{
+    static int Grow(int size, int required) { return MAX(required, size + size / 2); }
+};
+
+// Grows the capacity by Increment elements at a time
+template <int Increment> struct VectorGrowBy
+{
+    static int Grow(int size, int required) { return MAX(required, size + Increment); }
+};
+
+// Grows the capacity to exactly what's needed and no more
+struct VectorGrowExact
+{
+    static int Grow(int, int required) { return required; }
+};
+
 template <class ParameterType> class Predicate
 {
 public:
     virtual void operator() (ParameterType &param) = 0;
 };
 
-template <class VectorType> class Vector
+// A few bits of template machinery for telling predicates apart from lambdas and other functors, there being no <type_traits> on AVR
+template <bool Condition, class Type = void> struct VectorEnableIf { typedef Type type; };
+template <class Type> struct VectorEnableIf<false, Type> { };
+
+template <class Type> struct VectorRemoveReference { typedef Type type; };
+template <class Type> struct VectorRemoveReference<Type&> { typedef Type type; };
+template <class Type> struct VectorRemoveReference<Type&&> { typedef Type type; };
+
+// Passes on an argument with the same value category it was given with, like std::forward
+template <class Type> Type &&VectorForward(typename VectorRemoveReference<Type>::type &value) { return static_cast<Type&&>(value); }
+
+// Whether Functor is a subclass of Predicate<ParameterType>, in which case it goes to the ForEach that calls it virtually
+template <class Functor, class ParameterType> struct VectorIsPredicate
+{
+    static char Test(const volatile Predicate<ParameterType> *);
+    static long Test(...);
+
+    static const bool value = sizeof(Test((typename VectorRemoveReference<Functor>::type*)0)) == sizeof(char);
+};
+
+// Removes every element in the len elements at array for which functor returns true, moving each one that's kept down over the gaps
+// in a single pass. Returns the number of elements kept, what's left after them is for the caller to destroy.
+template <class VectorType, class Functor> int VectorCompact(VectorType *array, int len, Functor &functor)
+{
+    int kept = 0;
+
+    for(int i = 0; i < len; i++)
+    {
+        if(functor(const_cast<const VectorType&>(array[i])))
+            continue;
+
+        if(kept != i)
+            array[kept] = static_cast<VectorType&&>(array[i]);
+
+        kept++;
+    }
+
+    return kept;
+}
+
+// The comparison that sorting and the binary searches use unless they're given another, it just uses operator<
+struct VectorLess
+{
+    template <class VectorType> bool operator()(const VectorType &a, const VectorType &b) const { return a < b; }
+};
+
+template <class VectorType> void VectorSwap(VectorType &a, VectorType &b)
+{
+    VectorType tmp(static_cast<VectorType&&>(a));
+    a = static_cast<VectorType&&>(b);
+    b = static_cast<VectorType&&>(tmp);
+}
+
+// Moves the element at root down the heap made of the first len elements of array until it's no smaller than either of its children
+template <class VectorType, class Compare> void VectorSiftDown(VectorType *array, int root, int len, Compare &compare)
+{
+    for(int child = 2 * root + 1; child < len; child = 2 * root + 1)
+    {
+        // Pick the larger of the two children
+        if(child + 1 < len && compare(array[child], array[child + 1]))
+            child++;
+
+        if(!compare(array[root], array[child]))
+            return;
+
+        VectorSwap(array[root], array[child]);
+        root = child;
+    }
+}
+
+// Sorts the len elements at array in place so that compare(array[i + 1], array[i]) is false throughout. Short arrays get an insertion
+// sort and anything longer a heapsort, so it's O(n log n) in the worst case, needs no memory besides a couple of elements' worth on the
+// stack and doesn't recurse. It isn't stable though - elements that compare equal may not stay in the order they were in.
+template <class VectorType, class Compare> void VectorSort(VectorType *array, int len, Compare &compare)
 {
+    if(len <= 16)
+    {
+        for(int i = 1; i < len; i++)
+        {
+            VectorType value(static_cast<VectorType&&>(array[i]));
+            int j = i;
+
+            for(; j > 0 && compare(value, array[j - 1]); j--)
+                array[j] = static_cast<VectorType&&>(array[j - 1]);
+
+            array[j] = static_cast<VectorType&&>(value);
+        }
+
+        return;
+    }
+
+    // Arrange the array into a heap with the largest element at the front...
+    for(int i = len / 2 - 1; i >= 0; i--)
+        VectorSiftDown(array, i, len, compare);
+
+    // ...then repeatedly swap that to the end and restore the heap in what's left
+    for(int end = len - 1; end > 0; end--)
+    {
+        VectorSwap(array[0], array[end]);
+        VectorSiftDown(array, 0, end, compare);
+    }
+}
+
+// Returns the index of the first of the len sorted elements at array which doesn't compare less than value, or len if there isn't one
+template <class VectorType, class Compare> int VectorLowerBound(const VectorType *array, int len, const VectorType &value, Compare &compare)
+{
+    int first = 0;
+
+    while(len > 0)
+    {
+        int half = len / 2;
+
+        if(compare(array[first + half], value))
+        {
+            first += half + 1;
+            len -= half + 1;
+        }
+        else
+            len = half;
+    }
+
+    return first;
+}
+
+// Returns the index of the first of the len sorted elements at array which compares greater than value, or len if there isn't one
+template <class VectorType, class Compare> int VectorUpperBound(const VectorType *array, int len, const VectorType &value, Compare &compare)
+{
+    int first = 0;
+
+    while(len > 0)
+    {
+        int half = len / 2;
+
+        if(!compare(value, array[first + half]))
+        {
+            first += half + 1;
+            len -= half + 1;
+        }
+        else
+            len = half;
+    }
+
+    return first;
+}
+
+// Returns the index of an element equal to value among the len sorted elements at array, or -1 if there isn't one
+template <class VectorType, class Compare> int VectorFindSorted(const VectorType *array, int len, const VectorType &value, Compare &compare)
+{
+    int i = VectorLowerBound(array, len, value, compare);
+
+    return (i < len && !compare(value, array[i])) ? i : -1;
+}
+
+// These four combine two containers sorted by compare into output in a single pass over each, so they take O(n + m) where looking up
+// each element of one in the other with Contains would take O(n * m). The inputs can be anything with Data() and Size() - a Vector, a
+// SortedVector or a VectorView, say - and output is emptied and has room reserved for the largest possible result up front, so it's
+// never reallocated along the way. It can't be one of the inputs. Each returns false, leaving output empty, if that reservation fails.
+//
+// Elements that compare equal are matched up one to one, so if a holds three of something and b holds two, the union ends up with
+// three of them, the intersection two and the difference one.
+
+// Puts every element of both a and b into output, in order. Where elements compare equal the ones from a come first.
+template <class First, class Second, class Output, class Compare = VectorLess>
+bool VectorMerge(const First &a, const Second &b, Output &output, Compare compare = Compare())
+{
+    output.Clear();
+
+    if(!output.Reserve(a.Size() + b.Size()))
+        return false;
+
+    int i = 0, j = 0;
+
+    while(i < a.Size() && j < b.Size())
+    {
+        if(compare(b.Data()[j], a.Data()[i]))
+            output.PushBack(b.Data()[j++]);
+        else
+            output.PushBack(a.Data()[i++]);
+    }
+
+    output.PushBack(a.Data() + i, a.Size() - i);
+    output.PushBack(b.Data() + j, b.Size() - j);
+
+    return true;
+}
+
+// Puts every element that's in a, b or both into output, in order
+template <class First, class Second, class Output, class Compare = VectorLess>
+bool VectorUnion(const First &a, const Second &b, Output &output, Compare compare = Compare())
+{
+    output.Clear();
+
+    if(!output.Reserve(a.Size() + b.Size()))
+        return false;
+
+    int i = 0, j = 0;
+
+    while(i < a.Size() && j < b.Size())
+    {
+        if(compare(a.Data()[i], b.Data()[j]))
+            output.PushBack(a.Data()[i++]);
+        else if(compare(b.Data()[j], a.Data()[i]))
+            output.PushBack(b.Data()[j++]);
+        else
+        {
+            output.PushBack(a.Data()[i++]);
+            j++;
+        }
+    }
+
+    output.PushBack(a.Data() + i, a.Size() - i);
+    output.PushBack(b.Data() + j, b.Size() - j);
+
+    return true;
+}
+
+// Puts every element that's in both a and b into output, in order
+template <class First, class Second, class Output, class Compare = VectorLess>
+bool VectorIntersect(const First &a, const Second &b, Output &output, Compare compare = Compare())
+{
+    output.Clear();
+
+    if(!output.Reserve(MIN(a.Size(), b.Size())))
+        return false;
+
+    int i = 0, j = 0;
+
+    while(i < a.Size() && j < b.Size())
+    {
+        if(compare(a.Data()[i], b.Data()[j]))
+            i++;
+        else if(compare(b.Data()[j], a.Data()[i]))
+            j++;
+        else
+        {
+            output.PushBack(a.Data()[i++]);
+            j++;
+        }
+    }
+
+    return true;
+}
+
+// Puts every element that's in a but not in b into output, in order
+template <class First, class Second, class Output, class Compare = VectorLess>
+bool VectorDifference(const First &a, const Second &b, Output &output, Compare compare = Compare())
+{
+    output.Clear();
+
+    if(!output.Reserve(a.Size()))
+        return false;
+
+    int i = 0, j = 0;
+
+    while(i < a.Size() && j < b.Size())
+    {
+        if(compare(a.Data()[i], b.Data()[j]))
+            output.PushBack(a.Data()[i++]);
+        else if(compare(b.Data()[j], a.Data()[i]))
+            j++;
+        else
+        {
+            i++;
+            j++;
+        }
+    }
+
+    output.PushBack(a.Data() + i, a.Size() - i);
+
+    return true;
+}
+
+// WriteTo and ReadFrom start the elements off with a short header: this version number, the size of an element and the number of
+// elements, the last two being written seven bits to a byte so that any vector of fewer than 128 elements takes a single byte for
+// it. After that the elements are transferred up to VECTOR_SERIAL_CHUNK bytes at a time.
+#define VECTOR_SERIAL_VERSION 1
+
+#ifndef VECTOR_SERIAL_CHUNK
+#define VECTOR_SERIAL_CHUNK 64
+#endif
+
+// Writes value to header seven bits at a time, the top bit of each byte saying whether there's another to come. Returns the number of
+// bytes it took, which is never more than five.
+inline int VectorSerialVarint(uint8_t *header, unsigned long value)
+{
+    int len = 0;
+
+    do
+    {
+        header[len] = (value & 0x7F) | (value > 0x7F ? 0x80 : 0);
+        value >>= 7;
+    }
+    while(header[len++] & 0x80);
+
+    return len;
+}
+
+// Reads back a value written by VectorSerialVarint, calling next() for each byte. next() returns -1 once there are none left, in
+// which case (or if the value's too long to be one of ours) this returns false.
+template <class Next> bool VectorSerialReadVarint(Next &next, unsigned long &value)
+{
+    value = 0;
+
+    for(int shift = 0; shift < 35; shift += 7)
+    {
+        int byte = next();
+
+        if(byte < 0)
+            return false;
+
+        value |= (unsigned long)(byte & 0x7F) << shift;
+
+        if(!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+// Writes a byte to EEPROM for WriteTo, through update if memory has one (the int argument picks this overload when it does) and write
+// if it doesn't
+template <class Memory> auto VectorSerialPut(Memory &memory, int address, uint8_t value, int) -> decltype(memory.update(address, value), void())
+{
+    memory.update(address, value);
+}
+
+template <class Memory> void VectorSerialPut(Memory &memory, int address, uint8_t value, long) { memory.write(address, value); }
+
+// The largest number of elements a vector can count with SizeType, which has to be an integer type no wider than an int
+template <class SizeType> struct VectorSizeLimit
+{
+    static_assert(sizeof(SizeType) <= sizeof(int), "A vector's SizeType can't be wider than an int");
+
+    static const long long bits = sizeof(SizeType) * 8, limit = (SizeType)-1 > 0 ? (1LL << bits) - 1 : (1LL << (bits - 1)) - 1;
+    static const int value = limit < (int)(~0U >> 1) ? (int)limit : (int)(~0U >> 1);
+};
+
+// SizeType is what the vector counts its elements and capacity with. The default is an int, but a vector that's never going to hold
+// more than 255 (or 65535) elements can use a uint8_t (or uint16_t) to save a few bytes in every instance. Asking such a vector to
+// grow past that fails just as it would if the memory ran out.
+//
+// The allocator is a base class rather than a member so that an allocator with nothing in it, like the default, takes no room at all.
+template <class VectorType, class Allocator = VectorHeapAllocator, class Growth = VectorGrowDouble, class SizeType = int>
+class Vector : private Allocator
+{
+    // The most elements the vector can hold
+    static const int Limit = VectorSizeLimit<SizeType>::value;
+
     // The address of the first element of the vector
-    VectorType *begin;
-    // The address one after the last allocated entry in the underlying array
-    VectorType *storage;
-    // The index of the most recent element put in the underlying array - the head
-    int head;
+    VectorType *buffer;
+    // The number of elements in the vector and the number there's room for in the underlying array. Only the first count entries
+    // hold elements, the rest is raw memory waiting for elements to be constructed in it.
+    SizeType count, capacity;
+    // Whether the underlying array was handed over by Adopt, in which case it's not the vector's to free
+    bool adopted;
 
 public:
     // The value that is returned when the caller asks for an element that is out of the bounds of the vector
+#ifdef VECTOR_SHARED_OB
+    static VectorType OB;
+#else
     VectorType OB;
+#endif
 
     // We can save a few re-sizings if we know how large the array is likely to grow to be
-    Vector(int initialSize = 0)
+    Vector(int initialSize = 0, const Allocator &allocator = Allocator()) : Allocator(allocator), buffer(NULL), count(0), capacity(0), adopted(false)
     {
-        begin = new VectorType[initialSize]; //points to the beginning of the new array
-        head = initialSize - 1;
-        storage = begin + initialSize; //points to the element one outside of the array (such that end - begin = capacity)
+        Resize(initialSize);
     }
 
-    Vector(Vector &obj)
+    Vector(const Allocator &allocator) : Allocator(allocator), buffer(NULL), count(0), capacity(0), adopted(false) { }
+
+    // Builds the vector from a list of elements in braces, copying them straight into an array of just the right size:
+    //
+    //   Vector<int> pins = { 2, 3, 5, 7 };
+    //
+    // Bear in mind that this means Vector<int> v{5} is a vector holding a 5. Use round brackets, Vector<int> v(5), for five elements.
+    Vector(std::initializer_list<VectorType> list, const Allocator &allocator = Allocator())
+        : Allocator(allocator), buffer(NULL), count(0), capacity(0), adopted(false)
     {
-        begin = new VectorType[0]; // Points to the beginning of the new array, it's zero but this line keeps malloc from seg faulting should we delete begin before resizing it
-        head = -1;
-        storage = begin; //points to the element one outside of the array (such that end - begin = capacity)
+        Assign(list.begin(), list.size());
+    }
 
+    // The copy draws its storage from the same place that obj does
+    Vector(const Vector &obj) : Allocator(obj.GetAllocator()), buffer(NULL), count(0), capacity(0), adopted(false)
+    {
         *this = obj;
     }
 
-    // If there's anything in the vector then delete the array, if there's no array then doing will will cause seg faults
-    virtual ~Vector() { delete[] begin; }
+    // Takes over obj's underlying array rather than copying its elements, leaving obj empty. This is what lets a vector be returned
+    // from a function, or handed on to another, without a copy of every element and an allocation along the way.
+    Vector(Vector &&obj) : Allocator(obj.GetAllocator()), buffer(NULL), count(0), capacity(0), adopted(false)
+    {
+        Take(obj);
+    }
 
-    Vector &operator=(Vector &obj)
+    VECTOR_VIRTUAL ~Vector()
     {
-        // Reallocate the underlying buffer to the same size as the
-        Resize(obj.Size());
+        Clear();
+        FreeBuffer();
+    }
 
-        for(int i = 0; i < obj.Size(); i++)
-            (*this)[i] = obj[i];
+    Vector &operator=(const Vector &obj)
+    {
+        if(&obj != this)
+            Assign(obj.buffer, obj.Size());
 
-        head = obj.head;
+        return *this;
+    }
+
+    // Replaces the elements with a list of them in braces. If there isn't enough memory for them the vector is left as it was.
+    Vector &operator=(std::initializer_list<VectorType> list)
+    {
+        Assign(list.begin(), list.size());
+
+        return *this;
+    }
+
+    // Frees this vector's array and takes over obj's, along with the allocator it came from
+    Vector &operator=(Vector &&obj)
+    {
+        if(&obj != this)
+        {
+            Take(obj);
+            GetAllocator() = obj.GetAllocator();
+        }
 
         return *this;
     }
@@ -78,193 +735,765 @@ public:
     void ForEach(Predicate<VectorType> &functor)
     {
         for(int i =  0; i < Size(); i++)
-            functor(begin[i]);
+            functor(buffer[i]);
+    }
+
+    // The same as above but for lambdas and any other functor that can be called with a VectorType&. Since the compiler can see just
+    // what's being called it can inline it and optimise the loop as a whole, where calling a Predicate is a virtual call every time.
+    template <class Functor> typename VectorEnableIf<!VectorIsPredicate<Functor, VectorType>::value>::type ForEach(Functor &&functor)
+    {
+        for(VectorType *element = begin(); element != end(); ++element)
+            functor(*element);
+    }
+
+    // Replaces each element with the result of calling functor on it
+    template <class Functor> void Transform(Functor &&functor)
+    {
+        for(VectorType *element = begin(); element != end(); ++element)
+            *element = functor(*element);
+    }
+
+    // Returns the number of elements for which functor returns true
+    template <class Functor> int CountIf(Functor &&functor) const
+    {
+        int matches = 0;
+
+        for(const VectorType *element = begin(); element != end(); ++element)
+            if(functor(*element))
+                matches++;
+
+        return matches;
+    }
+
+    // Returns the index of the first element for which functor returns true, or -1 if there isn't one
+    template <class Functor> int FindIf(Functor &&functor) const
+    {
+        for(int i = 0; i < Size(); i++)
+            if(functor(buffer[i]))
+                return i;
+
+        return -1;
+    }
+
+    // Erases every element for which functor returns true in a single pass, keeping the rest in order. Returns how many were erased.
+    template <class Functor> int RemoveIf(Functor &&functor)
+    {
+        int size = Size(), kept = VectorCompact(buffer, size, functor);
+
+        Destroy(kept, size);
+        count = kept;
+
+        return size - kept;
     }
 
     // Swaps the underlying array and characteristics of this vector with another of the same type, very quickly
     void Swap(Vector &obj)
     {
-        SWAP(int, head, obj.head);
-        SWAP(VectorType*, begin, obj.begin);
-        SWAP(VectorType*, storage, obj.storage);
+        SWAP(SizeType, count, obj.count);
+        SWAP(SizeType, capacity, obj.capacity);
+        SWAP(VectorType*, buffer, obj.buffer);
+        SWAP(bool, adopted, obj.adopted);
+
+        Allocator allocator = GetAllocator();
+        GetAllocator() = obj.GetAllocator();
+        obj.GetAllocator() = allocator;
     }
 
     // Checks the entire Vector to see whether a matching item exists. Bear in mind that the VectorType might need to implement
     // equality operator (operator==) for this to work properly.
-    bool Contains(VectorType element)
+    bool Contains(const VectorType &element) const { return Find(element) != -1; }
+
+    // Returns the index of the first element equal to element, or -1 if there isn't one. Vectors of integers and floats are searched
+    // several elements at a time where the processor allows, have a look at VectorScan.h for how.
+    int Find(const VectorType &element) const { return VectorScan<VectorType>::Find(buffer, Size(), element); }
+
+    // Returns the number of elements equal to element
+    int Count(const VectorType &element) const { return VectorScan<VectorType>::Count(buffer, Size(), element); }
+
+    // Returns the sum of the elements. Integers are added up in a wider type (see VectorAccumulator in VectorReduce.h), so a
+    // sum of int16_t is an int32_t and won't overflow until there are tens of thousands of them.
+    typename VectorAccumulator<VectorType>::type Sum() const { return VectorReduce<VectorType>::Sum(buffer, Size()); }
+
+    // Returns the smallest element, or a default constructed one if there aren't any
+    VectorType Min() const { return Size() ? VectorReduce<VectorType>::Min(buffer, Size()) : VectorType(); }
+
+    // Returns the largest element, or a default constructed one if there aren't any
+    VectorType Max() const { return Size() ? VectorReduce<VectorType>::Max(buffer, Size()) : VectorType(); }
+
+    // Finds the smallest and largest elements in one pass. Returns false, leaving min and max alone, if there aren't any.
+    bool MinMax(VectorType &min, VectorType &max) const
     {
-        for(int i = 0; i < Size(); i++)
-            if(operator [](i) == element)
-                return true;
+        if(!Size())
+            return false;
 
-        return false;
+        VectorReduce<VectorType>::MinMax(buffer, Size(), min, max);
+
+        return true;
     }
 
-    int Find(VectorType element)
+    // Returns the average of the elements, or zero if there aren't any
+    double Mean() const { return Size() ? (double)Sum() / Size() : 0; }
+
+    // Returns the sum of the products of each element and the one at the same index in other (a Vector, a StaticVector or a view of
+    // the same type), leaving out any elements past the end of the shorter one
+    template <class Container> typename VectorAccumulator<VectorType>::type Dot(const Container &other) const
     {
-        for(int i = 0; i < Size(); i++)
-            if(operator [](i) == element)
-                return i;
+        return VectorReduce<VectorType>::Dot(buffer, other.Data(), MIN(Size(), other.Size()));
+    }
 
-        return -1;
+    // Sorts the vector in place, by operator< unless it's given some other comparison (a lambda, say). See VectorSort for the details.
+    template <class Compare = VectorLess> void Sort(Compare compare = Compare()) { VectorSort(buffer, Size(), compare); }
+
+    // These three are binary searches, so they only work if the vector is sorted by the same comparison they're given, but they take
+    // O(log n) rather than the O(n) of Find. LowerBound returns the index of the first element not less than value (which is where
+    // value would be inserted to keep the vector sorted) and UpperBound the first element greater than it, either being Size() if
+    // there isn't one. FindSorted returns the index of an element equal to value, or -1 if there isn't one.
+    template <class Compare = VectorLess> int LowerBound(const VectorType &value, Compare compare = Compare()) const
+    {
+        return VectorLowerBound(buffer, Size(), value, compare);
     }
 
-    void PushBack(VectorType element) { PushBack(&element, 1); }
+    template <class Compare = VectorLess> int UpperBound(const VectorType &value, Compare compare = Compare()) const
+    {
+        return VectorUpperBound(buffer, Size(), value, compare);
+    }
 
-    void PushBack(const VectorType *elements, int len)
+    template <class Compare = VectorLess> int FindSorted(const VectorType &value, Compare compare = Compare()) const
     {
-        // If the length plus this's size is greater than the capacity, reallocate to that size.
-        if(len + Size() > Capacity())
-            ReAllocate(MAX(Size() + len, Size() * 2));
+        return VectorFindSorted(buffer, Size(), value, compare);
+    }
+
+    // Erases all but the first of each run of elements that compare equal, in a single pass, and returns how many were erased. In a
+    // sorted vector that leaves just one of each value.
+    template <class Compare = VectorLess> int Unique(Compare compare = Compare())
+    {
+        int size = Size(), kept = MIN(size, 1);
+
+        for(int i = 1; i < size; i++)
+        {
+            if(!compare(buffer[kept - 1], buffer[i]) && !compare(buffer[i], buffer[kept - 1]))
+                continue;
 
-        int append = MIN(storage - begin - head - 1, len), prepend = len - append;
+            if(kept != i)
+                buffer[kept] = static_cast<VectorType&&>(buffer[i]);
 
-        // memcpy the data starting at the head all the way up to the last element *(storage - 1)
-        memcpy((begin + head + 1), elements, sizeof(VectorType) * append);
+            kept++;
+        }
 
-        // If there's still data to copy memcpy whatever remains, starting at the first element *(begin) until the end of data. The first step will have ensured
-        // that we don't crash into the tail during this process.
-        memcpy(begin,(elements + append), sizeof(VectorType) * prepend);
+        Destroy(kept, size);
+        count = kept;
 
-        // Re-recalculate head and size.
-        head += len;
+        return size - kept;
+    }
+
+    // Returns false if there wasn't enough memory to fit the element in, in which case the vector is left as it was
+    bool PushBack(const VectorType &element) { return EmplaceBack(element); }
+    bool PushBack(VectorType &&element) { return EmplaceBack(static_cast<VectorType&&>(element)); }
+
+    bool PushBack(const VectorType *elements, int len) { return Insert(Size(), elements, len); }
+
+    // Constructs a new element at the back of the vector, passing arguments on to its constructor, rather than copying one in
+    template <class... Arguments> bool EmplaceBack(Arguments&&... arguments)
+    {
+        if(Size() < Capacity())
+        {
+            new (buffer + count, VectorPlacement()) VectorType(VectorForward<Arguments>(arguments)...);
+        }
+        else if(ResizeInPlace(Grown(Size() + 1), false))
+        {
+            // Nothing's moved, so the arguments are still good even if they refer to one of the elements
+            new (buffer + count, VectorPlacement()) VectorType(VectorForward<Arguments>(arguments)...);
+        }
+        else if(VectorIsTriviallyCopyable<VectorType>::value)
+        {
+            // The allocator may move the array itself, so the element is built before it does in case the arguments refer to one of
+            // those in it. Being trivially copyable, it costs no more to copy in afterwards.
+            VectorType element(VectorForward<Arguments>(arguments)...);
+
+            if(!ReAllocate(Grown(Size() + 1)))
+                return false;
+
+            new (buffer + count, VectorPlacement()) VectorType(static_cast<VectorType&&>(element));
+        }
+        else
+        {
+            int size = Grown(Size() + 1);
+            VectorType *_buffer = Allocate(size);
+
+            if(!_buffer)
+                return false;
+
+            // The new element goes into the new array before the old ones are moved out, in case the arguments refer to one of them
+            new (_buffer + count, VectorPlacement()) VectorType(VectorForward<Arguments>(arguments)...);
+
+            MoveTo(_buffer, size);
+        }
+
+        count++;
+
+        return true;
+    }
+
+    // Inserts element so that it ends up at the given position, moving everything from there on up by one. Returns false if position
+    // is past the end of the vector or there wasn't enough memory.
+    bool Insert(int position, VectorType element) { return Insert(position, &element, 1); }
+
+    // Inserts len elements starting at the given position, moving everything from there on up to make room. For trivially copyable
+    // types that's a single memmove. The elements can't come from this vector itself.
+    bool Insert(int position, const VectorType *elements, int len)
+    {
+        if(position < 0 || position > Size())
+            return false;
+
+        // If the length plus this's size is greater than the capacity, and the allocator can't resize the array, then the elements go
+        // straight into their place in a new array, with the old ones moved in around them
+        if(len + Size() > Capacity() && !ResizeInPlace(Grown(Size() + len), true))
+        {
+            int size = Grown(Size() + len);
+            VectorType *_buffer = Allocate(size);
+
+            if(!_buffer)
+                return false;
+
+            MoveTo(_buffer, size, position, len);
+        }
+        else
+        {
+            VectorCopier<VectorType>::RelocateUp(buffer + position + len, buffer + position, Size() - position);
+        }
+
+        // Copy the new elements into the raw memory that's been opened up for them
+        VectorCopier<VectorType>::Construct(buffer + position, elements, len);
+
+        // Re-recalculate the size.
+        count += len;
+
+        return true;
     }
 
     void Erase(unsigned int position) { Erase(position, position + 1); }
 
-    // Erase an arbitrary section of the vector from first up to last minus one. Like the stl counterpart, this is pretty labour intensive so go easy on it.
+    // Erase an arbitrary section of the vector from first up to last minus one. Like the stl counterpart, this has to shuffle everything
+    // after last down to fill the gap so go easy on it. For trivially copyable types that's a single memmove.
     void Erase(int first, int last)
     {
-        // For this we'll set the value of the array at first to the value of the array at last plus one. We'll do that all the way up to toIndex
-        for(int i = 0; i < (Size() - first); i++)
-        {
-            // If by trying to fill in the next element with the ones ahead of it we'll be running off the end of the vector, stop.
-            if((i + last) > (Size() - 1))
-                break;
+        // An empty range has nothing to erase, and the shuffle below would destroy elements it never moved
+        if(first >= last)
+            return;
+
+        VECTOR_STAT(VectorStats().erasedMoves += Size() - last);
+
+        VectorCopier<VectorType>::MoveDown(buffer + first, buffer + last, Size() - last);
 
-            begin[first + i] = begin[last + i];
+        // The elements at the end have all been shuffled down so they can go
+        Destroy(Size() - (last - first), Size());
+
+        // Adjust the count to reflect the new size
+        count -= last - first;
+    }
+
+    // Erases the element at position by moving the last element into its place. That takes constant time however large the vector is
+    // but doesn't keep the elements in order, which is fine for the many lists where the order doesn't matter anyway.
+    void EraseUnordered(int position)
+    {
+        if(position < 0 || position >= Size())
+            return;
+
+        if(position != count - 1)
+        {
+            VECTOR_STAT(VectorStats().erasedMoves++);
+            buffer[position] = static_cast<VectorType&&>(buffer[count - 1]);
         }
 
-        // Adjust the head to reflect the new size
-        head -= last - first;
+        PopBack();
+    }
+
+    // Erases every element equal to element in a single pass, keeping the rest in order. Returns how many were erased.
+    int EraseAll(const VectorType &element)
+    {
+        return RemoveIf([&element](const VectorType &candidate) { return candidate == element; });
     }
 
     // Remove the most recent element in the array
     void PopBack()
     {
         if(Size() > 0)
-            head--;
+        {
+            buffer[count - 1].~VectorType();
+            count--;
+        }
     }
 
-    // Empty the vector, or to be precise - forget the fact that there was ever anything in there.
-    void Clear() { head = -1; }
+    // Empty the vector, destroying each of its elements but keeping hold of the memory they were in
+    void Clear()
+    {
+        Destroy(0, Size());
+        count = 0;
+    }
 
     // Returns a bool indicating whether or not there are any elements in the array
-    bool Empty() { return head == -1; }
+    bool Empty() const { return count == 0; }
 
     // Returns the oldest element in the array (the one added before any other)
-    VectorType const &Back() { return *begin; }
+    VectorType const &Back() { return *buffer; }
 
     // Returns the newest element in the array (the one added after every other)
-    VectorType const &Front() { return begin[head]; }
+    VectorType const &Front() { return buffer[count - 1]; }
 
     // Returns the nth element in the vector
     VectorType &operator[](int n)
     {
         if(n < Size())
-            return begin[n];
+            return buffer[n];
         else
             return OB;
     }
 
+    // Returns the nth element without checking that there is one, so it's up to the caller to be sure that n is less than Size().
+    // This is the fast path for tight loops where operator[]'s bounds check would cost a compare and branch on every element.
+    VectorType &At(int n) { return buffer[n]; }
+    const VectorType &At(int n) const { return buffer[n]; }
+
     // Returns a pointer such that the vector's data is laid out between ret to ret + size
-    VectorType *Data() { return begin; }
+    VectorType *Data() { return buffer; }
+    const VectorType *Data() const { return buffer; }
 
-    // Recreates the vector to hold len elements, all being copies of val
-    void Assign(int len, const VectorType &val)
+    // Pointers to the first element and one past the last. These let the vector be walked with a plain pointer or used in a range-based
+    // for loop, either way the compiler gets a loop over an array with no bounds checks in it:
+    //
+    //   for(int &element : intVect)
+    //     element *= 2;
+    VectorType *begin() { return buffer; }
+    VectorType *end() { return buffer + Size(); }
+    const VectorType *begin() const { return buffer; }
+    const VectorType *end() const { return buffer + Size(); }
+
+    // Recreates the vector to hold len elements, all being copies of val. Returns false, leaving the vector as it was, if there
+    // wasn't enough memory.
+    bool Assign(int len, const VectorType &val)
     {
-        delete[] begin;
+        if(!Recreate(len))
+            return false;
 
-        // Allocate an array the same size as the one passed in
-        begin = new VectorType[len];
-        storage = begin + len;
+        for(int i = 0 ; i < len; i++)
+            new (buffer + i, VectorPlacement()) VectorType(val);
 
-        // Refresh the head and tail, assuming the array is in order, which it really has to be
-        head = len - 1;
+        // Refresh the count, assuming the array is in order, which it really has to be
+        count = len;
 
-        for(int i = 0 ; i < Size(); i++)
-            begin[i] = val;
+        return true;
     }
 
     // Recreates the vector using an external array
-    void Assign(VectorType *array, int len)
+    bool Assign(const VectorType *array, int len)
+    {
+        if(!Recreate(len))
+            return false;
+
+        // Copy over the elements
+        return PushBack(array, len);
+    }
+
+    // Has the vector use an array it doesn't own - a DMA buffer, say - in place of its own, without copying it. The first len elements
+    // of the array become the vector's elements and the vector can grow into the rest, up to capacity (len if it's left out). The
+    // vector never frees the array, so it has to outlive the vector, or at least its use of it. If the vector does need to grow past
+    // capacity it moves its elements into an array of its own from the allocator, just as it would when growing ordinarily, and
+    // leaves the adopted one alone from there on. This only works for trivially copyable types.
+    void Adopt(VectorType *array, int len, int capacity = -1)
+    {
+        static_assert(VectorIsTriviallyCopyable<VectorType>::value, "Only vectors of trivially copyable types can adopt an array");
+
+        Clear();
+        FreeBuffer();
+
+        buffer = array;
+        this->capacity = MAX(capacity, len);
+        count = len;
+        adopted = true;
+    }
+
+    // Returns whether the vector is using an array that it adopted
+    bool Adopted() const { return adopted; }
+
+    // Returns a view of len of the vector's elements starting at first, or of all of them if they're left out. Only the pointer and
+    // length are copied so views are a cheap way of passing (parts of) the vector around, but one is only good until the vector next
+    // reallocates.
+    VectorView<VectorType> View(int first = 0, int len = -1)
+    {
+        return VectorView<VectorType>(buffer, Size()).SubView(first, len);
+    }
+
+    VectorView<const VectorType> View(int first = 0, int len = -1) const
+    {
+        return VectorView<const VectorType>(buffer, Size()).SubView(first, len);
+    }
+
+    // Writes the vector to stream - Serial, a File on an SD card or anything else with a write(const uint8_t*, size_t) that returns
+    // the number of bytes written - with a header that lets ReadFrom check what it's reading. Returns false if stream didn't take
+    // everything. This only works for trivially copyable types, and the data is only readable by a processor with the same layout
+    // for VectorType as this one.
+    template <class Stream> bool WriteTo(Stream &stream) const
     {
-        delete[] begin;
+        static_assert(VectorIsTriviallyCopyable<VectorType>::value, "Only vectors of trivially copyable types can be written out");
 
-        // Allocate an array the same size as the one passed in
-        begin = new VectorType[len];
-        storage = begin + len;
+        uint8_t header[11];
+        int len = Header(header);
 
-        // Refresh the head and tail, assuming the array is in order, which it really has to be
-        head = len - 1;
+        if(stream.write(header, len) != (size_t)len)
+            return false;
 
-        // Copy over the memory
-        memcpy(begin, array, sizeof(VectorType) * len);
+        const uint8_t *data = (const uint8_t*)buffer;
+        unsigned long bytes = sizeof(VectorType) * Size();
+
+        for(unsigned long done = 0; done < bytes; done += VECTOR_SERIAL_CHUNK)
+        {
+            size_t chunk = MIN(bytes - done, (unsigned long)VECTOR_SERIAL_CHUNK);
+
+            if(stream.write(data + done, chunk) != chunk)
+                return false;
+        }
+
+        return true;
+    }
+
+    // Replaces the contents of the vector with what WriteTo wrote to stream, which can be anything with a readBytes(char*, size_t)
+    // that returns the number of bytes read. The header says how many elements are coming, so the vector is reserved once and the
+    // elements are read straight into it. Returns false if the header isn't one of ours or is for a different size of element, if
+    // there isn't enough memory, or if the stream ran dry partway through, in which case the vector holds whatever whole elements
+    // did arrive.
+    template <class Stream> bool ReadFrom(Stream &stream)
+    {
+        static_assert(VectorIsTriviallyCopyable<VectorType>::value, "Only vectors of trivially copyable types can be read in");
+
+        auto next = [&stream]() -> int
+        {
+            char byte;
+            return stream.readBytes(&byte, 1) == 1 ? (uint8_t)byte : -1;
+        };
+
+        unsigned long len;
+
+        if(!ReadHeader(next, len))
+            return false;
+
+        uint8_t *data = (uint8_t*)buffer;
+        unsigned long bytes = sizeof(VectorType) * len, done = 0;
+
+        while(done < bytes)
+        {
+            size_t chunk = MIN(bytes - done, (unsigned long)VECTOR_SERIAL_CHUNK), read = stream.readBytes((char*)data + done, chunk);
+
+            done += read;
+
+            if(read != chunk)
+                break;
+        }
+
+        count = done / sizeof(VectorType);
+
+        return done == bytes;
+    }
+
+    // The same again for EEPROM and anything else with a read(int address) and a write(int address, uint8_t value), the vector being
+    // written from address on. Where there's an update(address, value), as there is on AVR, that's used instead of write so that only
+    // the bytes that have changed wear the EEPROM. Returns the address just past the end of what was written, so that something else
+    // can be written after it. On the ESP boards EEPROM.commit() still needs calling afterwards.
+    template <class Memory> int WriteTo(Memory &memory, int address) const
+    {
+        static_assert(VectorIsTriviallyCopyable<VectorType>::value, "Only vectors of trivially copyable types can be written out");
+
+        uint8_t header[11];
+        int len = Header(header);
+
+        for(int i = 0; i < len; i++)
+            VectorSerialPut(memory, address++, header[i], 0);
+
+        const uint8_t *data = (const uint8_t*)buffer;
+
+        for(unsigned long i = 0; i < sizeof(VectorType) * Size(); i++)
+            VectorSerialPut(memory, address++, data[i], 0);
+
+        return address;
+    }
+
+    // Replaces the contents of the vector with what WriteTo wrote to memory at address. Returns the address just past the end of it,
+    // or -1 if there wasn't a vector of this type there or not enough memory to read it into.
+    template <class Memory> int ReadFrom(Memory &memory, int address)
+    {
+        static_assert(VectorIsTriviallyCopyable<VectorType>::value, "Only vectors of trivially copyable types can be read in");
+
+        auto next = [&memory, &address]() -> int { return (uint8_t)memory.read(address++); };
+
+        unsigned long len;
+
+        if(!ReadHeader(next, len))
+            return -1;
+
+        uint8_t *data = (uint8_t*)buffer;
+
+        for(unsigned long i = 0; i < sizeof(VectorType) * len; i++)
+            data[i] = memory.read(address++);
+
+        count = len;
+
+        return address;
     }
 
     // Returns the number of elements that the vector will support before needing resizing
-    int Capacity() { return (storage - begin); }
+    int Capacity() const { return capacity; }
 
     // Returns the number of elements in vector
-    int Size() { return head + 1; }
+    int Size() const { return count; }
 
     // Requests that the capacity of the allocated storage space for the elements
-    // of the vector be at least enough to hold size elements.
-    void Reserve(unsigned int size)
+    // of the vector be at least enough to hold size elements. Returns false if the memory couldn't be found.
+    bool Reserve(unsigned int size)
+    {
+        if(size > (unsigned int)Capacity())
+            return ReAllocate(size);
+
+        return true;
+    }
+
+    // Hands back any capacity beyond what the vector's elements need by reallocating to exactly Size(). Returns false if the
+    // memory for the smaller array couldn't be found, in which case the vector keeps the one it has.
+    bool ShrinkToFit()
     {
-        if(size > Capacity())
-            ReAllocate(size);
+        if(Capacity() > Size())
+            return ReAllocate(Size());
+
+        return true;
     }
 
-    // Resizes the vector
-    void Resize(unsigned int size)
+    // Resizes the vector, returning false (and leaving the size as it was) if the memory couldn't be found. Any new elements
+    // are default constructed and any that no longer fit are destroyed.
+    bool Resize(unsigned int size)
     {
         // If necessary, resize the underlying array to fit the new size
-        if(size > Capacity())
-            ReAllocate(size);
+        if(size > (unsigned int)Capacity())
+            if(!ReAllocate(size))
+                return false;
 
-        // Now revise the head and size (tail needn't change) to reflect the new size
-        head = size - 1;
+        for(int i = Size(); i < (int)size; i++)
+            new (buffer + i, VectorPlacement()) VectorType;
+
+        Destroy(size, Size());
+
+        // Now revise the count to reflect the new size
+        count = size;
+
+        return true;
     }
 
-private:
+protected:
 
-    void ReAllocate(unsigned int size)
+    // The allocator is a private base so that an empty one takes up no room, these get at it for the vector and anything derived from it
+    Allocator &GetAllocator() { return *this; }
+    const Allocator &GetAllocator() const { return *this; }
+
+    // Swaps the underlying array for one of size elements, moving the elements across. Returns false if the memory couldn't be found,
+    // in which case the vector is left just as it was.
+    bool ReAllocate(unsigned int size)
     {
+        // Where the allocator can resize the array itself there's no need for the old one and a new one at once
+        if(ResizeInPlace(size, true))
+            return true;
+
+        // Allocate an array twice the size of that of the old
+        VectorType *_buffer = Allocate(size);
+
+        // If there's no memory to be had then leave the vector just as it is
+        if(!_buffer && size > 0)
+            return false;
+
         // Just in case we're re-allocating less room than we had before, make sure that we don't overrun the buffer by trying to write more elements than
         // are now possible for this vector to hold.
         if(Size() > (int)size)
-            head = size - 1;
+        {
+            Destroy(size, Size());
+            count = size;
+        }
 
-        // Allocate an array twice the size of that of the old
-        VectorType *_begin = new VectorType[size];
-        VectorType *_storage = _begin + size;
+        MoveTo(_buffer, size);
 
-        int _head = Size() - 1;
+        return true;
+    }
 
-        // Copy across all the old array's data and rearrange it!
-        for(int i = 0; i < Size(); i++)
-            _begin[i] = (*this)[i];
+    // Writes the header that WriteTo puts before the elements into header, returning its length
+    int Header(uint8_t *header) const
+    {
+        header[0] = VECTOR_SERIAL_VERSION;
+
+        int len = 1 + VectorSerialVarint(header + 1, sizeof(VectorType));
+
+        return len + VectorSerialVarint(header + len, Size());
+    }
+
+    // Reads a header written by Header, calling next() for each byte, and if it's for a vector like this one empties the vector and
+    // reserves room for the len elements it says are coming
+    template <class Next> bool ReadHeader(Next &next, unsigned long &len)
+    {
+        unsigned long size;
+
+        if(next() != VECTOR_SERIAL_VERSION || !VectorSerialReadVarint(next, size) || size != sizeof(VectorType))
+            return false;
+
+        if(!VectorSerialReadVarint(next, len) || len > (unsigned long)Limit)
+            return false;
+
+        Clear();
+
+        return Reserve(len);
+    }
+
+    // Destroys the vector's elements and frees its array, then takes over obj's array and elements, leaving obj empty. The array
+    // goes back to this vector's allocator when it's freed, so it's up to the caller to be sure that's somewhere it can go.
+    void Take(Vector &obj)
+    {
+        Clear();
+        FreeBuffer();
+
+        buffer = obj.buffer;
+        count = obj.count;
+        capacity = obj.capacity;
+        adopted = obj.adopted;
+
+        obj.buffer = NULL;
+        obj.count = obj.capacity = 0;
+        obj.adopted = false;
+    }
+
+private:
+
+    // Returns the capacity to grow to when the vector needs room for required elements. If that's more than SizeType can count then
+    // it's left as it is, for Allocate to turn down.
+    int Grown(int required) const { return required > Limit ? required : MIN(Growth::Grow(Size(), required), Limit); }
+
+    // Gets raw memory for size elements from the allocator, or returns NULL if the allocator came up empty. Nothing is constructed
+    // in it, that's left until there's an element to put there.
+    VectorType *Allocate(int size)
+    {
+        if(size <= 0 || size > Limit)
+            return NULL;
+
+        VectorType *array = (VectorType*)GetAllocator().Allocate(sizeof(VectorType) * size);
+
+        VECTOR_STAT(VectorStats().allocations += (array != NULL));
+        VECTOR_STAT(VectorStats().allocatedBytes += array ? sizeof(VectorType) * size : 0);
+        VECTOR_STAT(VectorStats().failedAllocations += (array == NULL));
+
+        return array;
+    }
+
+    // Has the allocator change the size of the array to size elements without a second one being allocated: through TryExpand, which
+    // leaves it where it is, or if canMove is set and the elements are trivially copyable, through Reallocate, which may move it. Returns
+    // false, with the vector left as it was, if the allocator has neither or can't do it, or the array isn't one of the allocator's.
+    bool ResizeInPlace(int size, bool canMove)
+    {
+        if(!buffer || adopted || size < Size() || size <= 0 || size > Limit)
+            return false;
+
+        size_t oldBytes = sizeof(VectorType) * Capacity(), newBytes = sizeof(VectorType) * size;
+
+        if(VectorTryExpand(GetAllocator(), buffer, oldBytes, newBytes, 0))
+        {
+            VECTOR_STAT(VectorStats().Reallocated(this, Capacity(), size, sizeof(VectorType)));
+
+            capacity = size;
+            return true;
+        }
+
+        if(!canMove || !VectorIsTriviallyCopyable<VectorType>::value)
+            return false;
+
+        VectorType *_buffer = (VectorType*)VectorReallocate(GetAllocator(), buffer, oldBytes, newBytes, 0);
+
+        if(!_buffer)
+            return false;
+
+        VECTOR_STAT(VectorStats().Reallocated(this, Capacity(), size, sizeof(VectorType)));
+        VECTOR_STAT(VectorStats().allocations++);
+        VECTOR_STAT(VectorStats().allocatedBytes += newBytes);
+        VECTOR_STAT(VectorStats().freedBytes += oldBytes);
+
+        buffer = _buffer;
+        capacity = size;
+        return true;
+    }
+
+    // Hands an array of size elements' worth of memory back to the allocator. Whatever was in it should be destroyed by now.
+    void Free(VectorType *array, int size)
+    {
+        if(array)
+        {
+            VECTOR_STAT(VectorStats().freedBytes += sizeof(VectorType) * size);
+            GetAllocator().Deallocate(array, sizeof(VectorType) * size);
+        }
+    }
+
+    // Hands the underlying array back to the allocator, unless it was adopted in which case it's left for its owner to deal with
+    void FreeBuffer()
+    {
+        if(!adopted)
+            Free(buffer, Capacity());
+
+        adopted = false;
+    }
+
+    // Runs the destructor of each element from first up to last minus one, leaving raw memory in their place
+    void Destroy(int first, int last)
+    {
+        for(int i = first; i < last; i++)
+            buffer[i].~VectorType();
+    }
+
+    // Empties the vector, making sure there's room for size elements. If there's not enough room already then the old array is
+    // swapped for one of exactly size, otherwise (or if the memory can't be found) the array stays as it was.
+    bool Recreate(int size)
+    {
+        if(size <= Capacity())
+        {
+            Clear();
+            return true;
+        }
+
+        VectorType *_buffer = Allocate(size);
+
+        if(!_buffer)
+            return false;
+
+        VECTOR_STAT(VectorStats().Reallocated(this, Capacity(), size, sizeof(VectorType)));
+
+        Clear();
+        FreeBuffer();
+
+        buffer = _buffer;
+        capacity = size;
+
+        return true;
+    }
+
+    // Moves the vector's elements into _buffer, an array of size elements (which must be enough for them all), and frees the old array.
+    // If gap is given then that many elements' worth of raw memory is left at position for new elements to go into.
+    void MoveTo(VectorType *_buffer, int size, int position = 0, int gap = 0)
+    {
+        VECTOR_STAT(VectorStats().Reallocated(this, Capacity(), size, sizeof(VectorType)));
+
+        // Move all the old array's elements across, destroying the old ones as we go
+        VectorCopier<VectorType>::Relocate(_buffer, buffer, position);
+        VectorCopier<VectorType>::Relocate(_buffer + position + gap, buffer + position, Size() - position);
 
         // Free the old memory
-        delete[] begin;
+        FreeBuffer();
 
         // Redirect the old array to point to the new one
-        begin = _begin;
-        storage = _storage;
-        head = _head;
+        buffer = _buffer;
+        capacity = size;
     }
 };
 
-#endif // VECTOR_H
+#ifdef VECTOR_SHARED_OB
+template <class VectorType, class Allocator, class Growth, class SizeType> VectorType Vector<VectorType, Allocator, Growth, SizeType>::OB = VectorType();
+#endif
 
+#endif // VECTOR_H
@@ -0,0 +1,248 @@
+/*
+ * VectorParallel.h
+ *
+ *      Purpose: Versions of ForEach, Transform and a reduction that split the elements between the processor's cores - both cores of
+ *      an ESP32, both cores of an RP2040 if VECTOR_PARALLEL_USE_CORE1 is defined, or a thread per core on a desktop. Anywhere else
+ *      they run on the calling core just as ForEach would.
+ */
+
+#ifndef VECTOR_PARALLEL_H
+#define VECTOR_PARALLEL_H
+
+#include "Vector.h"
+
+// Which way the work gets shared out. Each of these runs one chunk on the calling core and the rest elsewhere, then waits for them.
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#if !defined(CONFIG_FREERTOS_UNICORE) && portNUM_PROCESSORS > 1
+#define VECTOR_PARALLEL_FREERTOS
+#endif
+// Core 1 of an RP2040 is reset and relaunched for every call, which stops whatever it was running - a sketch's setup1() and loop1(),
+// or the handler the core uses to pause it while flash is written. There's no telling from here whether it's in use, so it's only
+// borrowed when the sketch says it can be by defining VECTOR_PARALLEL_USE_CORE1 before including this. Otherwise it's left alone and
+// everything runs on core 0.
+#elif defined(ARDUINO_ARCH_RP2040) && defined(VECTOR_PARALLEL_USE_CORE1)
+#include <pico/multicore.h>
+#define VECTOR_PARALLEL_RP2040
+#elif !defined(ARDUINO) && defined(__has_include)
+#if __has_include(<thread>)
+#include <thread>
+#define VECTOR_PARALLEL_THREADS
+#endif
+#endif
+
+// Shorter runs of elements than this aren't worth the cost of starting up another core or thread, so they're done on the calling core
+#ifndef VECTOR_PARALLEL_MIN
+#define VECTOR_PARALLEL_MIN 256
+#endif
+
+// The most chunks the elements are ever split into
+#ifndef VECTOR_PARALLEL_MAX_CHUNKS
+#define VECTOR_PARALLEL_MAX_CHUNKS 8
+#endif
+
+// A chunk of work to run on another core: run(job, chunk, first, last) does the elements from first up to last minus one
+struct VectorParallelChunk
+{
+    void (*run)(void *job, int chunk, int first, int last);
+    void *job;
+    int chunk, first, last;
+#if defined(VECTOR_PARALLEL_FREERTOS)
+    SemaphoreHandle_t done;
+#endif
+};
+
+template <class Job> void VectorParallelRunJob(void *job, int chunk, int first, int last) { (*(Job*)job)(chunk, first, last); }
+
+#if defined(VECTOR_PARALLEL_FREERTOS)
+
+inline void VectorParallelTask(void *argument)
+{
+    VectorParallelChunk *chunk = (VectorParallelChunk*)argument;
+
+    chunk->run(chunk->job, chunk->chunk, chunk->first, chunk->last);
+    xSemaphoreGive(chunk->done);
+    vTaskDelete(NULL);
+}
+
+#elif defined(VECTOR_PARALLEL_RP2040)
+
+// The chunk core 1 is working on and whether it's finished. There's only the one other core so there's only ever one of these.
+inline VectorParallelChunk *&VectorParallelCore1Chunk()
+{
+    static VectorParallelChunk *chunk;
+    return chunk;
+}
+
+inline volatile bool &VectorParallelCore1Done()
+{
+    static volatile bool done;
+    return done;
+}
+
+inline void VectorParallelCore1()
+{
+    VectorParallelChunk *chunk = VectorParallelCore1Chunk();
+
+    chunk->run(chunk->job, chunk->chunk, chunk->first, chunk->last);
+    __atomic_store_n(&VectorParallelCore1Done(), true, __ATOMIC_RELEASE);
+}
+
+#endif
+
+// Returns the number of chunks len elements should be split into
+inline int VectorParallelChunks(int len)
+{
+    if(len < VECTOR_PARALLEL_MIN)
+        return 1;
+
+#if defined(VECTOR_PARALLEL_FREERTOS) || defined(VECTOR_PARALLEL_RP2040)
+    return 2;
+#elif defined(VECTOR_PARALLEL_THREADS)
+    int threads = std::thread::hardware_concurrency();
+    return MAX(1, MIN(threads, MIN(VECTOR_PARALLEL_MAX_CHUNKS, len / (VECTOR_PARALLEL_MIN / 2))));
+#else
+    return 1;
+#endif
+}
+
+// Splits len elements into chunks chunks of as near the same size as possible and runs job(chunk, first, last) for each of them at
+// the same time, returning once they're all done
+template <class Job> void VectorParallelRun(Job &job, int len, int chunks)
+{
+    VectorParallelChunk work[VECTOR_PARALLEL_MAX_CHUNKS];
+
+    for(int i = 0; i < chunks; i++)
+    {
+        work[i].run = VectorParallelRunJob<Job>;
+        work[i].job = &job;
+        work[i].chunk = i;
+        work[i].first = (long)len * i / chunks;
+        work[i].last = (long)len * (i + 1) / chunks;
+    }
+
+    // The first chunk always runs here, the others are farmed out
+#if defined(VECTOR_PARALLEL_FREERTOS)
+    if(chunks > 1)
+    {
+        work[1].done = xSemaphoreCreateBinary();
+
+        // If there's no room for another task then everything's done here instead
+        if(!work[1].done || xTaskCreatePinnedToCore(VectorParallelTask, "vector", 4096, work + 1, uxTaskPriorityGet(NULL), NULL,
+                                                     1 - xPortGetCoreID()) != pdPASS)
+        {
+            job(1, work[1].first, work[1].last);
+
+            if(work[1].done)
+                vSemaphoreDelete(work[1].done);
+
+            chunks = 1;
+        }
+    }
+
+    job(0, work[0].first, work[0].last);
+
+    if(chunks > 1)
+    {
+        xSemaphoreTake(work[1].done, portMAX_DELAY);
+        vSemaphoreDelete(work[1].done);
+    }
+#elif defined(VECTOR_PARALLEL_RP2040)
+    if(chunks > 1)
+    {
+        VectorParallelCore1Chunk() = work + 1;
+        VectorParallelCore1Done() = false;
+
+        multicore_reset_core1();
+        multicore_launch_core1(VectorParallelCore1);
+    }
+
+    job(0, work[0].first, work[0].last);
+
+    if(chunks > 1)
+        while(!__atomic_load_n(&VectorParallelCore1Done(), __ATOMIC_ACQUIRE))
+            ;
+#elif defined(VECTOR_PARALLEL_THREADS)
+    std::thread threads[VECTOR_PARALLEL_MAX_CHUNKS];
+
+    for(int i = 1; i < chunks; i++)
+        threads[i] = std::thread(job, i, work[i].first, work[i].last);
+
+    job(0, work[0].first, work[0].last);
+
+    for(int i = 1; i < chunks; i++)
+        threads[i].join();
+#else
+    for(int i = 0; i < chunks; i++)
+        job(i, work[i].first, work[i].last);
+#endif
+}
+
+// Calls functor on every element of container (a Vector, a StaticVector, a VectorView...) with the elements split between the cores.
+// Since it's called from more than one core at once, functor mustn't change anything that the calls for other elements use - each
+// call doing something to its own element and nothing else is the safe way. The order the elements are visited in isn't fixed.
+template <class Container, class Functor> void VectorParallelForEach(Container &&container, Functor functor)
+{
+    auto *elements = container.Data();
+
+    auto job = [elements, &functor](int, int first, int last)
+    {
+        for(int i = first; i < last; i++)
+            functor(elements[i]);
+    };
+
+    VectorParallelRun(job, container.Size(), VectorParallelChunks(container.Size()));
+}
+
+// Replaces each element with the result of calling functor on it, split between the cores the same way
+template <class Container, class Functor> void VectorParallelTransform(Container &&container, Functor functor)
+{
+    auto *elements = container.Data();
+
+    auto job = [elements, &functor](int, int first, int last)
+    {
+        for(int i = first; i < last; i++)
+            elements[i] = functor(elements[i]);
+    };
+
+    VectorParallelRun(job, container.Size(), VectorParallelChunks(container.Size()));
+}
+
+// Reduces the elements to a single value. Each core works through a chunk of the elements starting from initial, so for each one
+// result = reduce(result, element), and the results for the chunks are then put together in order with combine(result, result).
+// initial should be the value that makes no difference - zero for a sum, one for a product - and combine has to be associative, as
+// addition, multiplication, MIN and MAX all are, so that the answer's the same however the elements are split up.
+template <class Container, class Result, class Reduce, class Combine>
+Result VectorParallelReduce(const Container &container, Result initial, Reduce reduce, Combine combine)
+{
+    const auto *elements = container.Data();
+    int chunks = VectorParallelChunks(container.Size());
+    Result results[VECTOR_PARALLEL_MAX_CHUNKS];
+
+    auto job = [elements, &reduce, &results, &initial](int chunk, int first, int last)
+    {
+        Result result = initial;
+
+        for(int i = first; i < last; i++)
+            result = reduce(result, elements[i]);
+
+        results[chunk] = result;
+    };
+
+    VectorParallelRun(job, container.Size(), chunks);
+
+    for(int i = 1; i < chunks; i++)
+        results[0] = combine(results[0], results[i]);
+
+    return results[0];
+}
+
+// The same where the results for the chunks are put together with reduce as well, as with a sum of elements which are all Result
+template <class Container, class Result, class Reduce> Result VectorParallelReduce(const Container &container, Result initial, Reduce reduce)
+{
+    return VectorParallelReduce(container, initial, reduce, reduce);
+}
+
+#endif // VECTOR_PARALLEL_H
@@ -0,0 +1,104 @@
+/*
+ * VectorPool.h
+ *
+ *      Purpose: Lets any number of vectors draw their storage from one region of memory set aside up front, rather than
+ *      each scattering its own blocks across the heap.
+ */
+
+#ifndef VECTOR_POOL_H
+#define VECTOR_POOL_H
+
+#include "Vector.h"
+
+// A region of memory to hand out to vectors. Blocks are taken from the front of the region in order and only the most recent one
+// can be given back by itself - the space behind any other block is only recovered when Release() hands back the whole region in
+// one go. That makes every allocation a couple of additions and means the pool can't fragment.
+class VectorPool
+{
+    // Blocks are aligned well enough for any type that's likely to end up in a vector
+    union Alignment { long long l; double d; void *p; };
+
+    // The start of the region the pool hands out
+    uint8_t *region;
+    // How many bytes there are in the region
+    size_t size;
+    // How many bytes from the start of the region have been handed out so far
+    size_t used;
+    // The most recent block to be handed out, which is the only one that can be given back before Release()
+    uint8_t *last;
+
+public:
+    VectorPool(void *buffer, size_t size) : region((uint8_t*)buffer), size(size), used(0), last(NULL) { }
+
+    // Returns a block of bytes bytes from the region, or NULL if there isn't enough of it left
+    void *Allocate(size_t bytes)
+    {
+        // The buffer itself may not be aligned, so it's the address that gets rounded up rather than the offset into the region
+        uintptr_t address = (uintptr_t)(region + used);
+        size_t start = used + (alignof(Alignment) - address % alignof(Alignment)) % alignof(Alignment);
+
+        if(start > size || bytes > size - start)
+            return NULL;
+
+        last = region + start;
+        used = start + bytes;
+
+        return last;
+    }
+
+    // If ptr is the most recent block then its space goes back to the pool, otherwise it stays put until Release()
+    void Deallocate(void *ptr, size_t)
+    {
+        if(ptr && ptr == last)
+        {
+            used = last - region;
+            last = NULL;
+        }
+    }
+
+    // Changes the size of the most recent block where it is, so a vector at the end of the pool grows into the space after it without
+    // a second block. Returns false if ptr isn't the most recent block or there isn't room.
+    bool TryExpand(void *ptr, size_t, size_t bytes)
+    {
+        if(!ptr || ptr != last || bytes > size - (last - region))
+            return false;
+
+        used = last - region + bytes;
+
+        return true;
+    }
+
+    // Hands back the whole region at once. Any vector still using the pool must be cleared out (or gone) before calling this.
+    void Release()
+    {
+        used = 0;
+        last = NULL;
+    }
+
+    // Returns the number of bytes handed out since the pool was created or last released
+    size_t Used() { return used; }
+
+    // Returns the number of bytes left to hand out
+    size_t Available() { return size - used; }
+};
+
+// The allocator that points a vector at a pool, to use it declare the vector like so:
+//
+//   alignas(8) uint8_t buffer[512];
+//   VectorPool pool(buffer, sizeof(buffer));
+//   Vector<int, VectorPoolAllocator> intVect(pool);
+class VectorPoolAllocator
+{
+    VectorPool *pool;
+
+public:
+    VectorPoolAllocator(VectorPool &pool) : pool(&pool) { }
+
+    void *Allocate(size_t bytes) { return pool->Allocate(bytes); }
+
+    void Deallocate(void *ptr, size_t bytes) { pool->Deallocate(ptr, bytes); }
+
+    bool TryExpand(void *ptr, size_t oldBytes, size_t newBytes) { return pool->TryExpand(ptr, oldBytes, newBytes); }
+};
+
+#endif // VECTOR_POOL_H
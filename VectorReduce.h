@@ -0,0 +1,247 @@
+/*
+ * VectorReduce.h
+ *
+ *      Purpose: The loops behind Sum, Min, Max, MinMax, Mean and Dot. Sums are added up in a type wider than the elements so that
+ *      adding many small integers doesn't overflow, the loops are unrolled to keep several independent sums going at once, and 16 bit
+ *      data uses the dual multiply-accumulate of Cortex-M4 and M7 cores. This is included by Vector.h, there's no need to include it
+ *      yourself.
+ */
+
+#ifndef VECTOR_REDUCE_H
+#define VECTOR_REDUCE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "VectorScan.h"
+
+#if defined(__ARM_FEATURE_DSP) && !defined(__ARM_ARCH_ISA_A64)
+#define VECTOR_REDUCE_SMLAD
+#endif
+
+// The wider integer an integer of Size bytes is added up in: 32 bits for anything up to 16, 64 bits for anything bigger
+template <bool Signed, int Size> struct VectorWider { typedef int64_t type; };
+template <> struct VectorWider<false, 8> { typedef uint64_t type; };
+template <> struct VectorWider<false, 4> { typedef uint64_t type; };
+template <> struct VectorWider<true, 2> { typedef int32_t type; };
+template <> struct VectorWider<false, 2> { typedef uint32_t type; };
+template <> struct VectorWider<true, 1> { typedef int32_t type; };
+template <> struct VectorWider<false, 1> { typedef uint32_t type; };
+
+// The type that Sum and Dot add VectorType up in. The built in integers get one of the wider ones above, keeping their signedness,
+// and anything else (float, double or a type of your own) is added up as itself. Specialise this to change it.
+template <class VectorType> struct VectorAccumulator { typedef VectorType type; };
+
+#define VECTOR_ACCUMULATOR(element, isSigned) \
+    template <> struct VectorAccumulator<element> { typedef VectorWider<isSigned, sizeof(element)>::type type; };
+VECTOR_ACCUMULATOR(char, true)
+VECTOR_ACCUMULATOR(signed char, true)
+VECTOR_ACCUMULATOR(unsigned char, false)
+VECTOR_ACCUMULATOR(short, true)
+VECTOR_ACCUMULATOR(unsigned short, false)
+VECTOR_ACCUMULATOR(int, true)
+VECTOR_ACCUMULATOR(unsigned int, false)
+VECTOR_ACCUMULATOR(long, true)
+VECTOR_ACCUMULATOR(unsigned long, false)
+#undef VECTOR_ACCUMULATOR
+
+template <class VectorType> struct VectorAccumulator<const VectorType> : VectorAccumulator<VectorType> { };
+
+// The plain loops, which work for any type with operator+, operator* and operator<. Each one keeps four running results that don't
+// depend on each other, so the processor can be working on the next one before the last has finished.
+template <class VectorType> struct VectorReduceLoops
+{
+    typedef typename VectorAccumulator<VectorType>::type Accumulator;
+    typedef VectorType Element;
+
+    // Returns the sum of the len elements at array
+    static Accumulator Sum(const VectorType *array, int len)
+    {
+        Accumulator sums[4] = { Accumulator(), Accumulator(), Accumulator(), Accumulator() };
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            sums[0] += array[i];
+            sums[1] += array[i + 1];
+            sums[2] += array[i + 2];
+            sums[3] += array[i + 3];
+        }
+
+        for(; i < len; i++)
+            sums[0] += array[i];
+
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+
+    // Returns the sum of the products of the first len elements at a and at b
+    static Accumulator Dot(const VectorType *a, const VectorType *b, int len)
+    {
+        Accumulator sums[4] = { Accumulator(), Accumulator(), Accumulator(), Accumulator() };
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            sums[0] += (Accumulator)a[i] * b[i];
+            sums[1] += (Accumulator)a[i + 1] * b[i + 1];
+            sums[2] += (Accumulator)a[i + 2] * b[i + 2];
+            sums[3] += (Accumulator)a[i + 3] * b[i + 3];
+        }
+
+        for(; i < len; i++)
+            sums[0] += (Accumulator)a[i] * b[i];
+
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+
+    // Sets min and max to the smallest and largest of the len elements at array, which there must be at least one of. Elements are
+    // taken two at a time, so it's three comparisons for every two elements rather than four.
+    static void MinMax(const VectorType *array, int len, VectorType &min, VectorType &max)
+    {
+        int i = len % 2;
+
+        if(i)
+            min = max = array[0];
+        else if(array[1] < array[0])
+        {
+            min = array[1];
+            max = array[0];
+            i = 2;
+        }
+        else
+        {
+            min = array[0];
+            max = array[1];
+            i = 2;
+        }
+
+        for(; i < len; i += 2)
+        {
+            if(array[i + 1] < array[i])
+            {
+                if(array[i + 1] < min)
+                    min = array[i + 1];
+                if(max < array[i])
+                    max = array[i];
+            }
+            else
+            {
+                if(array[i] < min)
+                    min = array[i];
+                if(max < array[i + 1])
+                    max = array[i + 1];
+            }
+        }
+    }
+
+    // Returns the smallest of the len elements at array, which there must be at least one of
+    static VectorType Min(const VectorType *array, int len)
+    {
+        const VectorType *mins[4] = { array, array, array, array };
+        int i = 1;
+
+        for(; i + 4 <= len; i += 4)
+            for(int j = 0; j < 4; j++)
+                if(array[i + j] < *mins[j])
+                    mins[j] = array + i + j;
+
+        for(; i < len; i++)
+            if(array[i] < *mins[0])
+                mins[0] = array + i;
+
+        for(int j = 1; j < 4; j++)
+            if(*mins[j] < *mins[0])
+                mins[0] = mins[j];
+
+        return *mins[0];
+    }
+
+    // Returns the largest of the len elements at array, which there must be at least one of
+    static VectorType Max(const VectorType *array, int len)
+    {
+        const VectorType *maxes[4] = { array, array, array, array };
+        int i = 1;
+
+        for(; i + 4 <= len; i += 4)
+            for(int j = 0; j < 4; j++)
+                if(*maxes[j] < array[i + j])
+                    maxes[j] = array + i + j;
+
+        for(; i < len; i++)
+            if(*maxes[0] < array[i])
+                maxes[0] = array + i;
+
+        for(int j = 1; j < 4; j++)
+            if(*maxes[0] < *maxes[j])
+                maxes[0] = maxes[j];
+
+        return *maxes[0];
+    }
+};
+
+template <class VectorType> struct VectorReduce : VectorReduceLoops<VectorType> { };
+
+// Views of const elements are reduced just like the elements themselves
+template <class VectorType> struct VectorReduce<const VectorType> : VectorReduce<VectorType> { };
+
+#if defined(VECTOR_REDUCE_SMLAD)
+
+// SMLAD multiplies the two 16 bit halves of one register by those of another and adds both products to a 32 bit sum, all in one
+// cycle, so pairs of int16_t are loaded a word at a time and handled together. A sum is a dot product with a vector of ones.
+inline int32_t VectorSmlad(uint32_t x, uint32_t y, int32_t sum)
+{
+    int32_t result;
+
+    __asm__("smlad %0, %1, %2, %3" : "=r"(result) : "r"(x), "r"(y), "r"(sum));
+
+    return result;
+}
+
+template <> struct VectorReduce<int16_t> : VectorReduceLoops<int16_t>
+{
+    static int32_t Sum(const int16_t *array, int len)
+    {
+        int32_t sums[2] = { 0, 0 };
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            uint32_t x[2];
+
+            // memcpy is the portable way to load a word that may not be aligned, which the M4 and M7 can do in one instruction
+            memcpy(x, array + i, sizeof(x));
+            sums[0] = VectorSmlad(x[0], 0x00010001, sums[0]);
+            sums[1] = VectorSmlad(x[1], 0x00010001, sums[1]);
+        }
+
+        for(; i < len; i++)
+            sums[0] += array[i];
+
+        return sums[0] + sums[1];
+    }
+
+    static int32_t Dot(const int16_t *a, const int16_t *b, int len)
+    {
+        int32_t sums[2] = { 0, 0 };
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            uint32_t x[2], y[2];
+
+            memcpy(x, a + i, sizeof(x));
+            memcpy(y, b + i, sizeof(y));
+            sums[0] = VectorSmlad(x[0], y[0], sums[0]);
+            sums[1] = VectorSmlad(x[1], y[1], sums[1]);
+        }
+
+        for(; i < len; i++)
+            sums[0] += (int32_t)a[i] * b[i];
+
+        return sums[0] + sums[1];
+    }
+};
+
+#endif
+
+#endif // VECTOR_REDUCE_H
@@ -0,0 +1,339 @@
+/*
+ * VectorScan.h
+ *
+ *      Purpose: The loops behind Find, Contains and Count. Any type with an operator== gets a plain (if unrolled) loop, and the built in
+ *      integer types and float get kernels that compare several elements at a time: memchr for bytes, SSE2 on x86 and NEON on ARM
+ *      cores that have them. This is included by Vector.h, there's no need to include it yourself.
+ */
+
+#ifndef VECTOR_SCAN_H
+#define VECTOR_SCAN_H
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define VECTOR_SCAN_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VECTOR_SCAN_NEON
+#endif
+
+// Whether VectorType is one of the built in integer types, for which equality is just comparing bits and which can be scanned by the
+// kernels below rather than with one operator== at a time
+template <class VectorType> struct VectorIsInteger { static const bool value = false; };
+
+#define VECTOR_INTEGER(type) template <> struct VectorIsInteger<type> { static const bool value = true; };
+VECTOR_INTEGER(char)
+VECTOR_INTEGER(signed char)
+VECTOR_INTEGER(unsigned char)
+VECTOR_INTEGER(short)
+VECTOR_INTEGER(unsigned short)
+VECTOR_INTEGER(int)
+VECTOR_INTEGER(unsigned int)
+VECTOR_INTEGER(long)
+VECTOR_INTEGER(unsigned long)
+VECTOR_INTEGER(long long)
+VECTOR_INTEGER(unsigned long long)
+#undef VECTOR_INTEGER
+
+// The plain version, used for anything that doesn't have a kernel of its own. Kind is the size in bytes of an integer VectorType and
+// zero for anything else. The loops are unrolled by four so the loop overhead is paid a quarter as often.
+template <class VectorType, int Kind = VectorIsInteger<VectorType>::value ? sizeof(VectorType) : 0> struct VectorScan
+{
+    // Returns the index of the first of the len elements at array equal to value, or -1 if there isn't one
+    static int Find(const VectorType *array, int len, const VectorType &value)
+    {
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            if(array[i] == value)
+                return i;
+            if(array[i + 1] == value)
+                return i + 1;
+            if(array[i + 2] == value)
+                return i + 2;
+            if(array[i + 3] == value)
+                return i + 3;
+        }
+
+        for(; i < len; i++)
+            if(array[i] == value)
+                return i;
+
+        return -1;
+    }
+
+    // Returns the number of the len elements at array that are equal to value
+    static int Count(const VectorType *array, int len, const VectorType &value)
+    {
+        int count = 0, i = 0;
+
+        for(; i + 4 <= len; i += 4)
+            count += (array[i] == value) + (array[i + 1] == value) + (array[i + 2] == value) + (array[i + 3] == value);
+
+        for(; i < len; i++)
+            count += (array[i] == value);
+
+        return count;
+    }
+};
+
+// Bytes. memchr is about as quick a search as each platform's C library can manage (it's hand written assembly on AVR, for one), and
+// counting compares 16 bytes at a time with SSE2 or, on other 32 bit cores, 4 at a time packed into a word.
+template <class VectorType> struct VectorScan<VectorType, 1>
+{
+    static int Find(const VectorType *array, int len, const VectorType &value)
+    {
+        if(len <= 0)
+            return -1;
+
+        const VectorType *found = (const VectorType*)memchr(array, (unsigned char)value, len);
+
+        return found ? found - array : -1;
+    }
+
+    static int Count(const VectorType *array, int len, const VectorType &value)
+    {
+        int count = 0, i = 0;
+
+#if defined(VECTOR_SCAN_SSE2)
+        __m128i pattern = _mm_set1_epi8((char)value);
+
+        for(; i + 16 <= len; i += 16)
+            count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(array + i)), pattern)));
+#elif !defined(__AVR__)
+        const uint32_t pattern = (unsigned char)value * 0x01010101UL;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            uint32_t word;
+            memcpy(&word, array + i, 4);
+
+            // Bytes that match are zero after the xor. Adding 0x7F to the low seven bits of each byte carries into its top bit unless
+            // they were all zero, and or-ing in the byte itself covers the top bit, so the top bit of each byte ends up clear only
+            // where the byte matched.
+            word ^= pattern;
+            word = ((word & 0x7F7F7F7FUL) + 0x7F7F7F7FUL) | word;
+
+            count += __builtin_popcountl(~word & 0x80808080UL);
+        }
+#endif
+
+        for(; i < len; i++)
+            count += (array[i] == value);
+
+        return count;
+    }
+};
+
+#if defined(VECTOR_SCAN_SSE2)
+
+// 16 bit integers, eight at a time. Each element that matches sets two bits in the mask.
+template <class VectorType> struct VectorScan<VectorType, 2>
+{
+    static int Find(const VectorType *array, int len, const VectorType &value)
+    {
+        __m128i pattern = _mm_set1_epi16((short)value);
+        int i = 0;
+
+        for(; i + 8 <= len; i += 8)
+        {
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(array + i)), pattern));
+
+            if(mask)
+                return i + __builtin_ctz(mask) / 2;
+        }
+
+        int rest = VectorScan<VectorType, 0>::Find(array + i, len - i, value);
+
+        return rest == -1 ? -1 : i + rest;
+    }
+
+    static int Count(const VectorType *array, int len, const VectorType &value)
+    {
+        __m128i pattern = _mm_set1_epi16((short)value);
+        int count = 0, i = 0;
+
+        for(; i + 8 <= len; i += 8)
+            count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(array + i)), pattern))) / 2;
+
+        return count + VectorScan<VectorType, 0>::Count(array + i, len - i, value);
+    }
+};
+
+// 32 bit integers, four at a time. Each element that matches sets four bits in the mask.
+template <class VectorType> struct VectorScan<VectorType, 4>
+{
+    static int Find(const VectorType *array, int len, const VectorType &value)
+    {
+        __m128i pattern = _mm_set1_epi32((int)value);
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(array + i)), pattern));
+
+            if(mask)
+                return i + __builtin_ctz(mask) / 4;
+        }
+
+        int rest = VectorScan<VectorType, 0>::Find(array + i, len - i, value);
+
+        return rest == -1 ? -1 : i + rest;
+    }
+
+    static int Count(const VectorType *array, int len, const VectorType &value)
+    {
+        __m128i pattern = _mm_set1_epi32((int)value);
+        int count = 0, i = 0;
+
+        for(; i + 4 <= len; i += 4)
+            count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(array + i)), pattern))) / 4;
+
+        return count + VectorScan<VectorType, 0>::Count(array + i, len - i, value);
+    }
+};
+
+// Floats, four at a time. These compare as floats rather than bits, so 0.0 still matches -0.0 and NaN still matches nothing.
+template <> struct VectorScan<float, 0>
+{
+    static int Find(const float *array, int len, const float &value)
+    {
+        __m128 pattern = _mm_set1_ps(value);
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(array + i), pattern));
+
+            if(mask)
+                return i + __builtin_ctz(mask);
+        }
+
+        for(; i < len; i++)
+            if(array[i] == value)
+                return i;
+
+        return -1;
+    }
+
+    static int Count(const float *array, int len, const float &value)
+    {
+        __m128 pattern = _mm_set1_ps(value);
+        int count = 0, i = 0;
+
+        for(; i + 4 <= len; i += 4)
+            count += __builtin_popcount(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(array + i), pattern)));
+
+        for(; i < len; i++)
+            count += (array[i] == value);
+
+        return count;
+    }
+};
+
+#elif defined(VECTOR_SCAN_NEON)
+
+// Finds the first matching lane, if any, in the result of a NEON comparison of four elements
+inline int VectorScanLane(uint32x4_t matches)
+{
+    uint32x2_t either = vorr_u32(vget_low_u32(matches), vget_high_u32(matches));
+
+    if(!(vget_lane_u32(either, 0) | vget_lane_u32(either, 1)))
+        return -1;
+
+    if(vgetq_lane_u32(matches, 0))
+        return 0;
+    if(vgetq_lane_u32(matches, 1))
+        return 1;
+
+    return vgetq_lane_u32(matches, 2) ? 2 : 3;
+}
+
+// Adds up the lanes of a running count. Each matching lane of a comparison is all ones, i.e. -1, so subtracting the comparisons from
+// the count as they come adds one for each match.
+inline int VectorScanTotal(uint32x4_t counts)
+{
+    uint32x2_t sum = vadd_u32(vget_low_u32(counts), vget_high_u32(counts));
+
+    return vget_lane_u32(sum, 0) + vget_lane_u32(sum, 1);
+}
+
+// 32 bit integers, four at a time
+template <class VectorType> struct VectorScan<VectorType, 4>
+{
+    static int Find(const VectorType *array, int len, const VectorType &value)
+    {
+        uint32x4_t pattern = vdupq_n_u32((uint32_t)value);
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            int lane = VectorScanLane(vceqq_u32(vld1q_u32((const uint32_t*)(array + i)), pattern));
+
+            if(lane != -1)
+                return i + lane;
+        }
+
+        int rest = VectorScan<VectorType, 0>::Find(array + i, len - i, value);
+
+        return rest == -1 ? -1 : i + rest;
+    }
+
+    static int Count(const VectorType *array, int len, const VectorType &value)
+    {
+        uint32x4_t pattern = vdupq_n_u32((uint32_t)value), counts = vdupq_n_u32(0);
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+            counts = vsubq_u32(counts, vceqq_u32(vld1q_u32((const uint32_t*)(array + i)), pattern));
+
+        return VectorScanTotal(counts) + VectorScan<VectorType, 0>::Count(array + i, len - i, value);
+    }
+};
+
+// Floats, four at a time, compared as floats so 0.0 still matches -0.0 and NaN still matches nothing
+template <> struct VectorScan<float, 0>
+{
+    static int Find(const float *array, int len, const float &value)
+    {
+        float32x4_t pattern = vdupq_n_f32(value);
+        int i = 0;
+
+        for(; i + 4 <= len; i += 4)
+        {
+            int lane = VectorScanLane(vceqq_f32(vld1q_f32(array + i), pattern));
+
+            if(lane != -1)
+                return i + lane;
+        }
+
+        for(; i < len; i++)
+            if(array[i] == value)
+                return i;
+
+        return -1;
+    }
+
+    static int Count(const float *array, int len, const float &value)
+    {
+        float32x4_t pattern = vdupq_n_f32(value);
+        uint32x4_t counts = vdupq_n_u32(0);
+        int count = 0, i = 0;
+
+        for(; i + 4 <= len; i += 4)
+            counts = vsubq_u32(counts, vceqq_f32(vld1q_f32(array + i), pattern));
+
+        for(; i < len; i++)
+            count += (array[i] == value);
+
+        return VectorScanTotal(counts) + count;
+    }
+};
+
+#endif
+
+#endif // VECTOR_SCAN_H
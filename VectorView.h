@@ -0,0 +1,112 @@
+/*
+ * VectorView.h
+ *
+ *      Purpose: A pointer and a length, with the read side of the Vector interface on top. It's for handing (part of) a vector or any
+ *      other array around without copying it. This is included by Vector.h, there's no need to include it yourself.
+ */
+
+#ifndef VECTOR_VIEW_H
+#define VECTOR_VIEW_H
+
+#include "VectorReduce.h"
+#include "VectorScan.h"
+
+// A view doesn't own the elements it looks at, so whatever they're in has to stay put for as long as the view is used - for a Vector
+// that means until it next reallocates. Use VectorView<const VectorType> for a view that can't change the elements.
+template <class VectorType> class VectorView
+{
+    // The first element in view and the number of them
+    VectorType *elements;
+    int len;
+
+public:
+    // The value that is returned when the caller asks for an element that is out of the bounds of the view. It's shared by every view
+    // of the same type, so that a view is no bigger than its pointer and length.
+    static VectorType OB;
+
+    VectorView() : elements(NULL), len(0) { }
+
+    VectorView(VectorType *elements, int len) : elements(elements), len(len) { }
+
+    // A view of all of container's elements. Container can be anything with Data() and Size(), so a Vector, a StaticVector or
+    // another view will do.
+    template <class Container> VectorView(Container &container) : elements(container.Data()), len(container.Size()) { }
+
+    // Lets a view of VectorType be passed where a view of const VectorType is wanted
+    template <class OtherType> VectorView(const VectorView<OtherType> &view) : elements(view.Data()), len(view.Size()) { }
+
+    // Returns a view of len elements starting at first, or of everything from first on if len is left out. Both are clamped to this view.
+    VectorView SubView(int first, int len = -1) const
+    {
+        first = first < 0 ? 0 : (first > this->len ? this->len : first);
+        len = (len < 0 || len > this->len - first) ? this->len - first : len;
+
+        return VectorView(elements + first, len);
+    }
+
+    template <class Functor> void ForEach(Functor &&functor) const
+    {
+        for(VectorType *element = begin(); element != end(); ++element)
+            functor(*element);
+    }
+
+    bool Contains(const VectorType &element) const { return Find(element) != -1; }
+
+    // Returns the index of the first element equal to element, or -1 if there isn't one
+    int Find(const VectorType &element) const { return VectorScan<VectorType>::Find(elements, len, element); }
+
+    // Returns the number of elements equal to element
+    int Count(const VectorType &element) const { return VectorScan<VectorType>::Count(elements, len, element); }
+
+    // Sum, Min, Max, MinMax, Mean and Dot work just as Vector's do. Element is VectorType without any const, so that the results can
+    // be kept in a variable of their own.
+    typedef typename VectorReduce<VectorType>::Element Element;
+
+    typename VectorAccumulator<VectorType>::type Sum() const { return VectorReduce<VectorType>::Sum(elements, len); }
+
+    Element Min() const { return len ? VectorReduce<VectorType>::Min(elements, len) : Element(); }
+
+    Element Max() const { return len ? VectorReduce<VectorType>::Max(elements, len) : Element(); }
+
+    bool MinMax(Element &min, Element &max) const
+    {
+        if(!len)
+            return false;
+
+        VectorReduce<VectorType>::MinMax(elements, len, min, max);
+
+        return true;
+    }
+
+    double Mean() const { return len ? (double)Sum() / len : 0; }
+
+    template <class Container> typename VectorAccumulator<VectorType>::type Dot(const Container &other) const
+    {
+        return VectorReduce<VectorType>::Dot(elements, other.Data(), len < other.Size() ? len : other.Size());
+    }
+
+    bool Empty() const { return len == 0; }
+
+    // Returns the nth element in the view
+    VectorType &operator[](int n) const
+    {
+        if(n >= 0 && n < len)
+            return elements[n];
+        else
+            return OB;
+    }
+
+    // Returns the nth element without checking that there is one
+    VectorType &At(int n) const { return elements[n]; }
+
+    VectorType *Data() const { return elements; }
+
+    VectorType *begin() const { return elements; }
+    VectorType *end() const { return elements + len; }
+
+    int Size() const { return len; }
+};
+
+template <class VectorType> VectorType VectorView<VectorType>::OB = VectorType();
+
+#endif // VECTOR_VIEW_H
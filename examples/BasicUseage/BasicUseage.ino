@@ -1,16 +1,12 @@
 #include <Vector.h>
 
-Vector<int> intVect;
+// Start the vector off with a few elements, copied straight into an array of just the right size
+Vector<int> intVect = { 1, 2, 3, 4, 5 };
 
 void setup()
 {
   Serial.begin(9600);
   
-  int array[] = { 1, 2, 3, 4, 5 };
-  
-  // Fill the vector with the contents of the array
-  intVect.Assign(array, 5);
-  
   // Add another few elements to the array
   intVect.PushBack(6);
   intVect.PushBack(-300);
@@ -0,0 +1,71 @@
+#include <Vector.h>
+#include "VectorBenchmark.h"
+
+// Times PushBack, Erase, Find, ForEach, Assign and growth through ReAllocate and prints how many operations of each ran per second, along
+// with how many allocations they made and how many bytes those came to. Where the board has a cycle counter that's what does the timing,
+// otherwise it's micros(). The same benchmarks can be built for a desktop machine from extras/HostBenchmark.
+
+#if defined(ESP32) || defined(ESP8266)
+
+struct BenchmarkClock
+{
+    static unsigned long Now() { return ESP.getCycleCount(); }
+    static unsigned long TicksPerSecond() { return ESP.getCpuFreqMHz() * 1000000UL; }
+};
+
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+
+// Cortex-M3, M4 and M7 cores have a cycle counter in their DWT unit, it just needs switching on
+#define BENCHMARK_DEMCR (*(volatile uint32_t*)0xE000EDFC)
+#define BENCHMARK_DWT_CTRL (*(volatile uint32_t*)0xE0001000)
+#define BENCHMARK_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004)
+
+struct BenchmarkClock
+{
+    static unsigned long Now() { return BENCHMARK_DWT_CYCCNT; }
+    // The counter runs at the core clock. CMSIS keeps that in SystemCoreClock, which Teensy's core doesn't have, but there F_CPU is it.
+    static unsigned long TicksPerSecond()
+    {
+#if defined(TEENSYDUINO)
+        return F_CPU;
+#else
+        return SystemCoreClock;
+#endif
+    }
+
+    static void Begin()
+    {
+        BENCHMARK_DEMCR |= 1UL << 24;
+        BENCHMARK_DWT_CYCCNT = 0;
+        BENCHMARK_DWT_CTRL |= 1;
+    }
+};
+
+#else
+
+struct BenchmarkClock
+{
+    static unsigned long Now() { return micros(); }
+    static unsigned long TicksPerSecond() { return 1000000UL; }
+};
+
+#endif
+
+// Serial is a HardwareSerial on some boards and a USB class on others (Leonardo, native USB SAMD, RP2040, Teensy...), but it's always a
+// Print, which is all the benchmark needs
+VectorBenchmark<BenchmarkClock, Print> benchmark(Serial);
+
+void setup()
+{
+  Serial.begin(115200);
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+  BenchmarkClock::Begin();
+#endif
+
+  benchmark.Run();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,293 @@
+/*
+ * VectorBenchmark.h
+ *
+ *      Purpose: Times the common Vector operations and reports how many of each run per second and how much memory they took. It's
+ *      shared by the Benchmark sketch and the desktop build in extras/HostBenchmark, each of which supplies its own clock and output.
+ */
+
+#ifndef VECTOR_BENCHMARK_H
+#define VECTOR_BENCHMARK_H
+
+#include <Vector.h>
+
+// The number of elements each benchmark works with. AVR boards have to make do with something that'll fit in 2KB of RAM.
+#ifndef VECTOR_BENCHMARK_SIZE
+#if defined(__AVR__)
+#define VECTOR_BENCHMARK_SIZE 150
+#else
+#define VECTOR_BENCHMARK_SIZE 2000
+#endif
+#endif
+
+// Keeps count of everything the vectors being timed allocate. Blocks resized through the heap's Reallocate (or TryExpand, if it has
+// one) are counted separately from new ones, since those are what saves a vector holding its old array and a new one at once.
+struct BenchmarkAllocator
+{
+    static unsigned long allocations, resizes, bytes;
+
+    void *Allocate(size_t size)
+    {
+        allocations++;
+        bytes += size;
+
+        return heap.Allocate(size);
+    }
+
+    void Deallocate(void *ptr, size_t size) { heap.Deallocate(ptr, size); }
+
+    bool TryExpand(void *ptr, size_t oldSize, size_t newSize)
+    {
+        if(!VectorTryExpand(heap, ptr, oldSize, newSize, 0))
+            return false;
+
+        resizes++;
+        bytes += newSize > oldSize ? newSize - oldSize : 0;
+
+        return true;
+    }
+
+    // The bytes counted are only the ones the block grew by, whether or not it had to move to do it
+    void *Reallocate(void *ptr, size_t oldSize, size_t newSize)
+    {
+        void *block = VectorReallocate(heap, ptr, oldSize, newSize, 0);
+
+        if(block)
+        {
+            resizes++;
+            bytes += newSize > oldSize ? newSize - oldSize : 0;
+        }
+
+        return block;
+    }
+
+    VectorHeapAllocator heap;
+};
+
+unsigned long BenchmarkAllocator::allocations = 0, BenchmarkAllocator::resizes = 0, BenchmarkAllocator::bytes = 0;
+
+typedef Vector<int, BenchmarkAllocator> BenchmarkVector;
+
+// Things the benchmarks compute get written here so the compiler can't optimise them away
+volatile long benchmarkSink;
+
+class SumPredicate : public Predicate<int>
+{
+public:
+    long sum;
+
+    void operator() (int &element) { sum += element; }
+};
+
+// Runs each benchmark in turn and prints a line for it to output (Serial, say). Clock is anything with a static Now() returning a free
+// running tick count and a static TicksPerSecond().
+template <class Clock, class Output> class VectorBenchmark
+{
+    Output &output;
+
+    // The array that the bulk operations copy from, filled with 0, 1, 2...
+    int source[VECTOR_BENCHMARK_SIZE];
+
+    // When the benchmark being timed started, and what the allocation counters stood at
+    unsigned long start, allocations, resizes, bytes;
+
+public:
+    VectorBenchmark(Output &output) : output(output)
+    {
+        for(int i = 0; i < VECTOR_BENCHMARK_SIZE; i++)
+            source[i] = i;
+    }
+
+    void Run()
+    {
+        const int n = VECTOR_BENCHMARK_SIZE;
+
+        output.print("Vector benchmarks, ");
+        output.print((unsigned long)n);
+        output.println(" elements");
+        output.println("name, ops, ops/s, allocations, resizes, bytes allocated");
+
+        {
+            Start();
+            BenchmarkVector v;
+
+            for(int i = 0; i < n; i++)
+                v.PushBack(i);
+
+            Stop("PushBack (growing)", n);
+        }
+
+        {
+            BenchmarkVector v;
+            v.Reserve(n);
+
+            Start();
+
+            for(int i = 0; i < n; i++)
+                v.PushBack(i);
+
+            Stop("PushBack (reserved)", n);
+        }
+
+        {
+            Start();
+            BenchmarkVector v;
+
+            for(int i = 0; i < 10; i++)
+            {
+                v.Clear();
+                v.PushBack(source, n);
+            }
+
+            Stop("PushBack (bulk)", 10L * n);
+        }
+
+        {
+            Start();
+            BenchmarkVector v;
+
+            for(int i = 1; i <= n; i++)
+                v.Reserve(i);
+
+            Stop("Reserve (one at a time)", n);
+        }
+
+        {
+            BenchmarkVector v;
+
+            Start();
+
+            for(int i = 0; i < 10; i++)
+                v.Assign(source, n);
+
+            Stop("Assign", 10L * n);
+        }
+
+        {
+            BenchmarkVector v;
+            v.Assign(source, n);
+
+            Start();
+
+            while(!v.Empty())
+                v.Erase(0);
+
+            Stop("Erase (front)", n);
+        }
+
+        {
+            BenchmarkVector v;
+            v.Assign(source, n);
+
+            Start();
+
+            while(!v.Empty())
+                v.Erase(v.Size() / 2);
+
+            Stop("Erase (middle)", n);
+        }
+
+        {
+            BenchmarkVector v;
+            v.Assign(source, n);
+
+            Start();
+
+            while(!v.Empty())
+                v.Erase(v.Size() - 1);
+
+            Stop("Erase (back)", n);
+        }
+
+        {
+            BenchmarkVector v;
+            v.Assign(source, n);
+
+            Start();
+            long found = 0;
+
+            // Look for a spread of values, the last few of which aren't there at all
+            for(int i = 0; i < 100; i++)
+                found += v.Find((int)((long)i * n / 90));
+
+            benchmarkSink = found;
+            Stop("Find", 100);
+        }
+
+        {
+            BenchmarkVector v;
+            v.Assign(source, n);
+
+            Start();
+            SumPredicate sum;
+            sum.sum = 0;
+
+            for(int i = 0; i < 10; i++)
+                v.ForEach(sum);
+
+            benchmarkSink = sum.sum;
+            Stop("ForEach (Predicate)", 10L * n);
+        }
+
+        {
+            BenchmarkVector v;
+            v.Assign(source, n);
+
+            Start();
+            long sum = 0;
+
+            for(int i = 0; i < 10; i++)
+                v.ForEach([&sum](int &element) { sum += element; });
+
+            benchmarkSink = sum;
+            Stop("ForEach (lambda)", 10L * n);
+        }
+
+        {
+            BenchmarkVector v;
+            v.Assign(source, n);
+
+            Start();
+            long sum = 0;
+
+            for(int i = 0; i < 10; i++)
+                for(int j = 0; j < v.Size(); j++)
+                    sum += v[j];
+
+            benchmarkSink = sum;
+            Stop("operator[]", 10L * n);
+        }
+
+        output.println("done");
+    }
+
+private:
+
+    void Start()
+    {
+        allocations = BenchmarkAllocator::allocations;
+        resizes = BenchmarkAllocator::resizes;
+        bytes = BenchmarkAllocator::bytes;
+        start = Clock::Now();
+    }
+
+    // Prints the results of the benchmark that's just finished, ops being the number of operations it timed
+    void Stop(const char *name, long ops)
+    {
+        unsigned long ticks = Clock::Now() - start;
+
+        output.print(name);
+        output.print(", ");
+        output.print((unsigned long)ops);
+        output.print(", ");
+        output.print((unsigned long)(ticks ? (double)ops * Clock::TicksPerSecond() / ticks : 0));
+        output.print(", ");
+        output.print(BenchmarkAllocator::allocations - allocations);
+        output.print(", ");
+        output.print(BenchmarkAllocator::resizes - resizes);
+        output.print(", ");
+        output.print(BenchmarkAllocator::bytes - bytes);
+        output.println();
+    }
+};
+
+#endif // VECTOR_BENCHMARK_H
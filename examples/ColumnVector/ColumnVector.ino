@@ -0,0 +1,43 @@
+#include <ColumnVector.h>
+
+// Each reading is a timestamp, the channel it came from and the value read. They're stored a field to an array, so working through
+// the values doesn't drag the timestamps and channels through memory along with them.
+ColumnVector<unsigned long, uint8_t, int> readings;
+
+enum { Time, Channel, Value };
+
+void setup()
+{
+  Serial.begin(9600);
+}
+
+void loop()
+{
+  readings.PushBack(millis(), 0, analogRead(A0));
+  readings.PushBack(millis(), 1, analogRead(A1));
+
+  if(readings.Size() == 32)
+  {
+    // A pass over one field reads just the one array
+    long sum = 0;
+    for(int value : readings.Column<Value>())
+      sum += value;
+
+    Serial.print("Average: ");
+    Serial.println(sum / readings.Size());
+
+    // and the rest of each record is there for the ones that need it
+    for(int i = 0; i < readings.Size(); i++)
+      if(readings.At<Value>(i) > 1000)
+      {
+        Serial.print("High reading on channel ");
+        Serial.print(readings.At<Channel>(i));
+        Serial.print(" at ");
+        Serial.println(readings.At<Time>(i));
+      }
+
+    readings.Clear();
+  }
+
+  delay(50);
+}
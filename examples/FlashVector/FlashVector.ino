@@ -0,0 +1,30 @@
+#include <FlashVector.h>
+
+// A quarter of a sine wave, kept in flash rather than taking up RAM
+const uint8_t quarterSine[] PROGMEM = {
+  128, 140, 152, 165, 176, 188, 199, 209, 218, 227, 234, 241, 246, 250, 253, 255
+};
+
+FlashVector<uint8_t> wave(quarterSine);
+
+void setup()
+{
+  Serial.begin(9600);
+
+  // The table reads just like any other vector
+  for(uint8_t level : wave)
+    Serial.println(level);
+
+  Serial.print("255 is at ");
+  Serial.println(wave.Find(255));
+}
+
+void loop()
+{
+  // Play the table out forwards then backwards, each element being read out of flash as it's needed
+  for(int i = 0; i < wave.Size(); i++)
+    analogWrite(3, wave[i]);
+
+  for(int i = wave.Size() - 1; i >= 0; i--)
+    analogWrite(3, wave[i]);
+}
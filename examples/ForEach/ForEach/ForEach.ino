@@ -24,6 +24,16 @@ void setup()
   
   // Print off the results
   intVect.ForEach(printOff);
+
+  // ForEach will also take a lambda (or any other functor), which the compiler can inline rather than making a virtual call per element
+  int sum = 0;
+  intVect.ForEach([&sum](int &element) { sum += element; });
+  Serial.println(sum);
+
+  // Transform, CountIf, FindIf and RemoveIf take them too
+  intVect.Transform([](int element) { return element * 10; });
+  intVect.RemoveIf([](int element) { return element > 30; });
+  intVect.ForEach(printOff);
 }
 
 void loop()
@@ -0,0 +1,26 @@
+#include <RingBuffer.h>
+
+// Holds the last 16 readings, once it's full each new reading pushes out the oldest one
+RingBuffer<int, 16, true> readings;
+
+void setup()
+{
+  Serial.begin(9600);
+}
+
+void loop()
+{
+  readings.PushBack(analogRead(A0));
+
+  // Work out the average of the readings we're holding on to
+  long sum = 0;
+  readings.ForEach([&sum](int &reading) { sum += reading; });
+
+  Serial.println(sum / readings.Size());
+
+  // Readings can be taken off the front too, in the order they arrived and without shuffling any of the others along
+  if(readings.Full())
+    readings.PopFront();
+
+  delay(100);
+}
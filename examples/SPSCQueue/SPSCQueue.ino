@@ -0,0 +1,28 @@
+#include <SPSCQueue.h>
+
+// Samples go in from the timer interrupt and come out in loop(), with no need to turn interrupts off around either
+SPSCQueue<int, 64> samples;
+
+volatile unsigned long dropped = 0;
+
+// Call this from a timer interrupt, e.g. with the TimerOne library: Timer1.attachInterrupt(sample)
+void sample()
+{
+  if(!samples.PushBack(analogRead(A0)))
+    dropped++;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+}
+
+void loop()
+{
+  // Take everything that's arrived since last time in one go
+  int batch[16];
+  int count = samples.PopFront(batch, 16);
+
+  for(int i = 0; i < count; i++)
+    Serial.println(batch[i]);
+}
@@ -0,0 +1,30 @@
+#include <StaticVector.h>
+
+// A StaticVector keeps its elements inside itself rather than on the heap, so its capacity (here 8) has to be set at compile time
+StaticVector<int, 8> intVect;
+
+void setup()
+{
+  Serial.begin(9600);
+
+  int array[] = { 1, 2, 3, 4, 5 };
+
+  // Fill the vector with the contents of the array
+  intVect.Assign(array, 5);
+
+  // Keep adding elements until there's no room left, PushBack will return false once the vector is full
+  int i = 6;
+  while(intVect.PushBack(i))
+    i++;
+
+  Serial.print("Couldn't fit ");
+  Serial.println(i);
+
+  // Print off the results
+  for(int i = 0; i < intVect.Size(); i++)
+    Serial.println(intVect[i]);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,44 @@
+/*
+ * HostBenchmark.cpp
+ *
+ *      Purpose: Builds the benchmarks from examples/Benchmark for a desktop machine, which is a lot quicker to iterate on than
+ *      uploading to a board. From the root of the library:
+ *
+ *        g++ -std=gnu++11 -O2 -I. extras/HostBenchmark/HostBenchmark.cpp -o HostBenchmark && ./HostBenchmark
+ *
+ *      Pass -DVECTOR_BENCHMARK_SIZE=n to change the number of elements.
+ */
+
+#include <stdio.h>
+#include <chrono>
+
+#include "../../examples/Benchmark/VectorBenchmark.h"
+
+struct HostClock
+{
+    static unsigned long Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static unsigned long TicksPerSecond() { return 1000000000UL; }
+};
+
+// Just enough of Arduino's Print for the benchmarks to write to stdout
+struct HostOutput
+{
+    void print(const char *text) { fputs(text, stdout); }
+    void print(unsigned long value) { printf("%lu", value); }
+    void println(const char *text) { puts(text); }
+    void println() { putchar('\n'); }
+};
+
+int main()
+{
+    HostOutput output;
+    static VectorBenchmark<HostClock, HostOutput> benchmark(output);
+
+    benchmark.Run();
+
+    return 0;
+}